@@ -0,0 +1,71 @@
+#include "stdafx.h"
+#include "arch_cache.h"
+
+EntryCache::EntryCache(size_t budgetBytes, unsigned shardCount) {
+    shardCount = std::max(1u, shardCount);
+    m_shardBudget = budgetBytes / shardCount;
+    for (unsigned i = 0; i < shardCount; ++i) {
+        m_shards.emplace_back(new Shard());
+    }
+}
+
+EntryCache::Shard& EntryCache::ShardFor(uint64_t key) {
+    // Key berurutan (index entry) diacak dulu agar shard merata
+    uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+    return *m_shards[(hash >> 32) % m_shards.size()];
+}
+
+EntryCache::Handle EntryCache::Find(uint64_t key) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto found = shard.items.find(key);
+    if (found == shard.items.end()) {
+        shard.misses++;
+        return nullptr;
+    }
+    shard.hits++;
+    shard.order.splice(shard.order.begin(), shard.order, found->second);
+    return found->second->second;
+}
+
+EntryCache::Handle EntryCache::Insert(uint64_t key, Handle data) {
+    if (!data || data->size() > m_shardBudget) {
+        return data;
+    }
+
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto found = shard.items.find(key);
+    if (found != shard.items.end()) {
+        shard.order.splice(shard.order.begin(), shard.order, found->second);
+        return found->second->second;
+    }
+
+    while (!shard.order.empty() && shard.bytes + data->size() > m_shardBudget) {
+        auto& oldest = shard.order.back();
+        shard.bytes -= oldest.second->size();
+        shard.items.erase(oldest.first);
+        shard.order.pop_back();
+        shard.evictions++;
+    }
+
+    shard.order.emplace_front(key, data);
+    shard.items[key] = shard.order.begin();
+    shard.bytes += data->size();
+    return data;
+}
+
+EntryCache::Stats EntryCache::GetStats() const {
+    Stats stats;
+    for (const auto& shard : m_shards) {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        stats.hits += shard->hits;
+        stats.misses += shard->misses;
+        stats.evictions += shard->evictions;
+        stats.bytes += shard->bytes;
+        stats.entries += shard->items.size();
+    }
+    return stats;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Cache LRU berbatas byte untuk isi entry yang sudah didekripsi dan di-inflate.
+// Dibagi ke beberapa shard (masing-masing dengan lock dan anggaran sendiri)
+// supaya lookup dari banyak thread jarang saling menunggu. Data dibagikan
+// lewat shared_ptr, jadi entry yang di-evict tetap valid selama masih dipinjam.
+class EntryCache {
+public:
+    typedef std::shared_ptr<const std::vector<uint8_t>> Handle;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t bytes = 0;
+        uint64_t entries = 0;
+    };
+
+    EntryCache(size_t budgetBytes, unsigned shardCount = 16);
+
+    // nullptr jika tidak ada; hit/miss dihitung di sini
+    Handle Find(uint64_t key);
+    // Mengembalikan handle yang tersimpan (bisa milik thread lain yang lebih
+    // dulu memasukkan key yang sama). Data yang lebih besar dari anggaran satu
+    // shard tidak disimpan dan dikembalikan apa adanya.
+    Handle Insert(uint64_t key, Handle data);
+    Stats GetStats() const;
+
+private:
+    struct Shard {
+        mutable std::mutex lock;
+        std::list<std::pair<uint64_t, Handle>> order; // depan = paling baru dipakai
+        std::unordered_map<uint64_t, std::list<std::pair<uint64_t, Handle>>::iterator> items;
+        size_t bytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    Shard& ShardFor(uint64_t key);
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    size_t m_shardBudget;
+
+    EntryCache(const EntryCache&) = delete;
+    EntryCache& operator=(const EntryCache&) = delete;
+};
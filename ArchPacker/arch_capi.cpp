@@ -0,0 +1,485 @@
+#include "stdafx.h"
+#include "arch_capi.h"
+#include "arch_packer.h"
+#include "arch_reader.h"
+#include "arch_scanner.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// ArchReader aman dipakai dari banyak thread, jadi handle archive juga
+struct arch_archive {
+    ArchReader reader;
+    std::vector<uint8_t> key;
+    bool cached = false;
+};
+
+struct arch_blob {
+    EntryCache::Handle data;
+};
+
+struct arch_writer {
+    std::string output;
+    arch_create_options options;
+    std::string passphrase;
+    std::string policyFile;
+    std::vector<ManifestEntry> manifest;
+};
+
+namespace {
+    thread_local std::string g_lastError;
+
+    int Fail(int code, const std::string& message) {
+        g_lastError = message;
+        return code;
+    }
+
+    int Succeed() {
+        g_lastError.clear();
+        return ARCH_OK;
+    }
+
+    // Payload entry delta baru bermakna setelah diterapkan ke archive base-nya
+    // Tombstone dan delta punya index tetapi tidak punya isi file yang bisa dibaca
+    int CheckReadable(const FileEntry& entry) {
+        if (entry.flags & FileEntry::FLAG_TOMBSTONE) {
+            return Fail(ARCH_E_NOT_FOUND, "File sudah dihapus (tombstone): " + std::string(entry.filename));
+        }
+        if (entry.flags & FileEntry::FLAG_DELTA) {
+            return Fail(ARCH_E_INVALID, "Entry delta butuh archive base: " + std::string(entry.filename));
+        }
+        return ARCH_OK;
+    }
+
+    // Menyalin options dari pemanggil; struct_size yang lebih kecil berarti
+    // pemanggil dikompilasi dengan versi header lama, field baru tetap default
+    arch_create_options ReadOptions(const arch_create_options* options) {
+        arch_create_options result;
+        arch_default_options(&result);
+        if (options) {
+            size_t size = std::min<size_t>(options->struct_size, sizeof(result));
+            memcpy(&result, options, size);
+            result.struct_size = sizeof(result);
+        }
+        return result;
+    }
+
+    // Archive sudah ditulis tanpa file yang gagal; pemanggil tetap harus tahu
+    int CheckFailures(const ArchPacker& packer) {
+        const std::vector<std::string>& failures = packer.GetFailures();
+        if (failures.empty()) {
+            return Succeed();
+        }
+        std::string message = std::to_string(failures.size()) + " file gagal dikemas";
+        for (const auto& failure : failures) {
+            message += "\n" + failure;
+        }
+        return Fail(ARCH_E_IO, message);
+    }
+
+    void ConfigurePacker(ArchPacker& packer, const arch_create_options& options) {
+        // Sama seperti -p: jika policy punya encrypt=yes, hanya file itu yang dienkripsi
+        bool hasPassphrase = options.passphrase && options.passphrase[0] != '\0';
+        std::string encryptPattern;
+        if (options.policy_file && options.policy_file[0] != '\0') {
+            ArchPolicy policy;
+            policy.Load(options.policy_file);
+            encryptPattern = policy.GetEncryptPattern();
+            if (!encryptPattern.empty() && !hasPassphrase) {
+                throw std::invalid_argument("Aturan policy '" + encryptPattern +
+                    "' meminta enkripsi tetapi passphrase tidak diberikan");
+            }
+            packer.SetPolicy(policy);
+        }
+        if (hasPassphrase) {
+            packer.SetEncryptionKey(options.passphrase, encryptPattern.empty());
+        }
+        packer.SetStreamingLayout(options.streamed != 0);
+        packer.SetLocalHeaders(options.local_headers != 0);
+        packer.SetResume(options.resume != 0);
+        if (options.alignment > 1) {
+            packer.SetAlignment(options.alignment);
+        }
+        packer.SetMaxMemory(options.max_memory);
+    }
+}
+
+const char* arch_last_error(void) {
+    return g_lastError.c_str();
+}
+
+void arch_default_options(arch_create_options* options) {
+    if (!options) return;
+    memset(options, 0, sizeof(*options));
+    options->struct_size = sizeof(*options);
+    options->compress = 1;
+    options->alignment = 1;
+}
+
+int arch_open(const char* path, const char* passphrase, arch_archive** out) {
+    if (!path || !out) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+    *out = nullptr;
+
+    try {
+        std::unique_ptr<arch_archive> archive(new arch_archive());
+        if (!archive->reader.Open(path)) {
+            int code = GetFileAttributesA(path) == INVALID_FILE_ATTRIBUTES ? ARCH_E_IO : ARCH_E_CORRUPT;
+            return Fail(code, archive->reader.GetError());
+        }
+        if (passphrase && passphrase[0] != '\0') {
+            archive->key = ArchCrypto::GenerateKey(passphrase);
+        }
+        *out = archive.release();
+        return Succeed();
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+void arch_close(arch_archive* archive) {
+    delete archive;
+}
+
+uint32_t arch_entry_count(const arch_archive* archive) {
+    return archive ? archive->reader.GetEntryCount() : 0;
+}
+
+int arch_entry_at(const arch_archive* archive, uint32_t index, arch_entry_info* info) {
+    if (!archive || !info || index >= archive->reader.GetEntryCount()) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    const FileEntry& entry = archive->reader.GetEntry(index);
+    info->name = entry.filename;
+    info->size = entry.size;
+    info->stored_size = entry.compressedSize > 0 ? entry.compressedSize : entry.size;
+    info->timestamp = entry.timestamp;
+    info->checksum = entry.checksum;
+    info->compressed = entry.compressionType != 0;
+    info->encrypted = entry.encryptionType != 0;
+    info->deleted = (entry.flags & FileEntry::FLAG_TOMBSTONE) != 0;
+    info->delta = (entry.flags & FileEntry::FLAG_DELTA) != 0;
+    return Succeed();
+}
+
+int arch_find(const arch_archive* archive, const char* name, uint32_t* index) {
+    if (!archive || !name || !index) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    const FileEntry* found = archive->reader.FindEntry(name);
+    if (!found) {
+        return Fail(ARCH_E_NOT_FOUND, std::string("File tidak ditemukan di archive: ") + name);
+    }
+    *index = static_cast<uint32_t>(found - &archive->reader.GetEntry(0));
+    return Succeed();
+}
+
+int arch_read(arch_archive* archive, uint32_t index,
+    void* buffer, size_t capacity, size_t* out_size) {
+    if (!archive || index >= archive->reader.GetEntryCount() || (!buffer && capacity > 0)) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    const FileEntry& entry = archive->reader.GetEntry(index);
+    int readable = CheckReadable(entry);
+    if (readable != ARCH_OK) {
+        return readable;
+    }
+    if (out_size) {
+        *out_size = entry.size;
+    }
+    if (capacity < entry.size) {
+        return Fail(ARCH_E_BUFFER, "Buffer terlalu kecil untuk " + std::string(entry.filename));
+    }
+    archive->reader.LogAccess(entry);
+
+    if (archive->cached) {
+        EntryCache::Handle data = archive->reader.ReadEntryData(entry, archive->key);
+        if (!data) {
+            return Fail(ARCH_E_CORRUPT, archive->reader.GetError());
+        }
+        // capacity hanya dicek terhadap entry.size
+        if (data->size() != entry.size) {
+            return Fail(ARCH_E_CORRUPT, "Ukuran data tidak cocok untuk " + std::string(entry.filename));
+        }
+        memcpy(buffer, data->data(), data->size());
+        return Succeed();
+    }
+
+    size_t written = 0;
+    auto sink = [&](const uint8_t* data, size_t size) {
+        if (written + size > capacity) {
+            throw std::runtime_error("Data melebihi ukuran entry");
+        }
+        memcpy(static_cast<uint8_t*>(buffer) + written, data, size);
+        written += size;
+    };
+
+    if (!archive->reader.ReadEntry(entry, archive->key, sink)) {
+        return Fail(ARCH_E_CORRUPT, archive->reader.GetError());
+    }
+    return Succeed();
+}
+
+int arch_stream(arch_archive* archive, uint32_t index, arch_write_fn write, void* user) {
+    if (!archive || !write || index >= archive->reader.GetEntryCount()) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+    int readable = CheckReadable(archive->reader.GetEntry(index));
+    if (readable != ARCH_OK) {
+        return readable;
+    }
+    archive->reader.LogAccess(archive->reader.GetEntry(index));
+
+    if (archive->cached) {
+        EntryCache::Handle data = archive->reader.ReadEntryData(archive->reader.GetEntry(index), archive->key);
+        if (!data) {
+            return Fail(ARCH_E_CORRUPT, archive->reader.GetError());
+        }
+        if (!data->empty() && write(user, data->data(), data->size()) != 0) {
+            return Fail(ARCH_E_ABORTED, "Dihentikan oleh callback");
+        }
+        return Succeed();
+    }
+
+    bool aborted = false;
+    auto sink = [&](const uint8_t* data, size_t size) {
+        if (write(user, data, size) != 0) {
+            aborted = true;
+            throw std::runtime_error("Dihentikan oleh callback");
+        }
+    };
+
+    if (!archive->reader.ReadEntry(archive->reader.GetEntry(index), archive->key, sink)) {
+        return Fail(aborted ? ARCH_E_ABORTED : ARCH_E_CORRUPT, archive->reader.GetError());
+    }
+    return Succeed();
+}
+
+int arch_set_cache(arch_archive* archive, uint64_t budget_bytes) {
+    if (!archive || budget_bytes > SIZE_MAX) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    try {
+        archive->reader.EnableCache(static_cast<size_t>(budget_bytes));
+        archive->cached = budget_bytes > 0;
+        return Succeed();
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+int arch_get_cache_stats(const arch_archive* archive, arch_cache_stats* stats) {
+    if (!archive || !stats) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    EntryCache::Stats current = archive->reader.GetCacheStats();
+    stats->hits = current.hits;
+    stats->misses = current.misses;
+    stats->evictions = current.evictions;
+    stats->bytes = current.bytes;
+    stats->entries = current.entries;
+    return Succeed();
+}
+
+int arch_acquire(arch_archive* archive, uint32_t index,
+    const void** data, size_t* size, arch_blob** blob) {
+    if (!archive || !data || !size || !blob || index >= archive->reader.GetEntryCount()) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+    int readable = CheckReadable(archive->reader.GetEntry(index));
+    if (readable != ARCH_OK) {
+        return readable;
+    }
+    archive->reader.LogAccess(archive->reader.GetEntry(index));
+
+    try {
+        EntryCache::Handle handle = archive->reader.ReadEntryData(archive->reader.GetEntry(index), archive->key);
+        if (!handle) {
+            return Fail(ARCH_E_CORRUPT, archive->reader.GetError());
+        }
+        *blob = new arch_blob{ handle };
+        *data = handle->data();
+        *size = handle->size();
+        return Succeed();
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+void arch_release(arch_blob* blob) {
+    delete blob;
+}
+
+int arch_prefetch(arch_archive* archive, const char* const* names, size_t count) {
+    if (!archive || (!names && count > 0)) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+    if (!archive->cached) {
+        return Fail(ARCH_E_INVALID, "Cache belum diaktifkan (arch_set_cache)");
+    }
+
+    try {
+        std::vector<std::string> list;
+        list.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!names[i]) {
+                return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+            }
+            list.emplace_back(names[i]);
+        }
+        // Hasil diambil lewat cache, future tidak perlu ditunggu
+        archive->reader.Prefetch(list, archive->key);
+        return Succeed();
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+int arch_enable_access_log(arch_archive* archive, const char* log_file) {
+    if (!archive || !log_file) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+    if (!archive->reader.EnableAccessLog(log_file)) {
+        return Fail(ARCH_E_IO, archive->reader.GetError());
+    }
+    return Succeed();
+}
+
+int arch_create(const char* output, const char* const* inputs, size_t count,
+    const arch_create_options* options) {
+    if (!output || (!inputs && count > 0)) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    try {
+        arch_create_options settings = ReadOptions(options);
+        ArchPacker packer;
+        ConfigurePacker(packer, settings);
+
+        std::vector<std::string> inputFiles(inputs, inputs + count);
+        if (!packer.CreateArchive(output, inputFiles, settings.compress != 0)) {
+            return Fail(ARCH_E_IO, packer.GetError());
+        }
+        return CheckFailures(packer);
+    }
+    catch (const std::invalid_argument& e) {
+        return Fail(ARCH_E_INVALID, e.what());
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+int arch_writer_begin(const char* output, const arch_create_options* options, arch_writer** out) {
+    if (!output || !out) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    try {
+        std::unique_ptr<arch_writer> writer(new arch_writer());
+        writer->output = output;
+        writer->options = ReadOptions(options);
+        // Passphrase milik pemanggil bisa sudah dibebaskan saat finish
+        if (writer->options.passphrase) {
+            writer->passphrase = writer->options.passphrase;
+            writer->options.passphrase = writer->passphrase.c_str();
+        }
+        if (writer->options.policy_file) {
+            writer->policyFile = writer->options.policy_file;
+            writer->options.policy_file = writer->policyFile.c_str();
+        }
+        *out = writer.release();
+        return Succeed();
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+int arch_writer_add_file(arch_writer* writer, const char* source_path, const char* archive_path) {
+    if (!writer || !source_path) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    try {
+        ManifestEntry item;
+        item.sourcePath = source_path;
+        item.archivePath = archive_path ? archive_path : fs::path(source_path).filename().string();
+        if (item.archivePath.empty() || item.archivePath.length() >= ArchConstants::MAX_FILENAME_LENGTH) {
+            return Fail(ARCH_E_INVALID, "Path di archive kosong atau terlalu panjang: " + item.archivePath);
+        }
+        if (!ArchScanner::StatFile(item.sourcePath, item)) {
+            return Fail(ARCH_E_IO, "Cannot open input file: " + item.sourcePath);
+        }
+        writer->manifest.push_back(std::move(item));
+        return Succeed();
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+int arch_writer_add_buffer(arch_writer* writer, const char* archive_path,
+    const void* data, size_t size, uint64_t timestamp) {
+    if (!writer || !archive_path || (!data && size > 0)) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    try {
+        ManifestEntry item;
+        item.archivePath = archive_path;
+        if (item.archivePath.empty() || item.archivePath.length() >= ArchConstants::MAX_FILENAME_LENGTH) {
+            return Fail(ARCH_E_INVALID, "Path di archive kosong atau terlalu panjang: " + item.archivePath);
+        }
+        if (size > UINT32_MAX) {
+            return Fail(ARCH_E_INVALID, "Data melebihi batas 4 GB format archive");
+        }
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        item.data = std::make_shared<const std::vector<uint8_t>>(bytes, bytes + size);
+        item.sourcePath = "<memori>/" + item.archivePath;
+        item.size = size;
+        item.timestamp = timestamp;
+        writer->manifest.push_back(std::move(item));
+        return Succeed();
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+int arch_writer_finish(arch_writer* writer) {
+    if (!writer) {
+        return Fail(ARCH_E_INVALID, "Argumen tidak valid");
+    }
+
+    std::unique_ptr<arch_writer> owned(writer);
+    try {
+        ArchPacker packer;
+        ConfigurePacker(packer, owned->options);
+        if (!packer.CreateArchive(owned->output, owned->manifest, owned->options.compress != 0)) {
+            return Fail(ARCH_E_IO, packer.GetError());
+        }
+        return CheckFailures(packer);
+    }
+    catch (const std::invalid_argument& e) {
+        return Fail(ARCH_E_INVALID, e.what());
+    }
+    catch (const std::exception& e) {
+        return Fail(ARCH_E_IO, e.what());
+    }
+}
+
+void arch_writer_abort(arch_writer* writer) {
+    delete writer;
+}
@@ -0,0 +1,132 @@
+#pragma once
+/*
+ * libarchpacker - C API untuk membaca dan membuat archive .arch
+ *
+ * Semua fungsi mengembalikan ARCH_OK (0) atau kode error negatif; pesan
+ * lengkapnya tersedia lewat arch_last_error() pada thread yang sama.
+ * String berupa UTF-8/ANSI path seperti pada tool command line.
+ *
+ * Satu arch_archive boleh dibaca dari banyak thread sekaligus (arch_find,
+ * arch_read, arch_stream) tanpa lock; arch_close hanya setelah semua selesai.
+ *
+ * Link statis: definisikan ARCHPACKER_STATIC sebelum meng-include header ini.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(ARCHPACKER_STATIC)
+#define ARCHPACKER_API
+#elif defined(ARCHPACKER_EXPORTS)
+#define ARCHPACKER_API __declspec(dllexport)
+#else
+#define ARCHPACKER_API __declspec(dllimport)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARCH_OK              0
+#define ARCH_E_INVALID      -1  /* argumen tidak valid */
+#define ARCH_E_IO           -2  /* gagal membuka/membaca/menulis file */
+#define ARCH_E_NOT_FOUND    -3  /* entry tidak ada di archive */
+#define ARCH_E_CORRUPT      -4  /* checksum/format tidak cocok */
+#define ARCH_E_BUFFER       -5  /* buffer terlalu kecil; lihat out_size */
+#define ARCH_E_ABORTED      -6  /* callback menghentikan proses */
+
+typedef struct arch_archive arch_archive;
+typedef struct arch_writer arch_writer;
+typedef struct arch_blob arch_blob;
+
+typedef struct arch_entry_info {
+    const char* name;           /* valid selama archive terbuka */
+    uint64_t size;              /* ukuran asli */
+    uint64_t stored_size;       /* ukuran di archive (setelah kompresi) */
+    uint64_t timestamp;         /* detik Unix */
+    uint32_t checksum;
+    uint32_t compressed;        /* 0/1 */
+    uint32_t encrypted;         /* 0/1 */
+    uint32_t deleted;           /* 0/1: tombstone archive patch, bukan file */
+    uint32_t delta;             /* 0/1: size adalah ukuran patch, butuh archive base */
+} arch_entry_info;
+
+typedef struct arch_cache_stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t bytes;             /* data yang sedang tersimpan di cache */
+    uint64_t entries;
+} arch_cache_stats;
+
+/* Dipanggil untuk setiap potongan data; kembalikan selain 0 untuk berhenti */
+typedef int (*arch_write_fn)(void* user, const void* data, size_t size);
+
+typedef struct arch_create_options {
+    uint32_t struct_size;       /* sizeof(arch_create_options) */
+    uint32_t compress;          /* 0 = simpan apa adanya */
+    const char* passphrase;     /* NULL = tanpa enkripsi; dengan encrypt=yes di policy
+                                   hanya file yang dipilih policy dienkripsi */
+    uint32_t streamed;          /* layout streaming (footer di akhir) */
+    uint32_t local_headers;     /* header per entry untuk ekstraksi sekuensial */
+    uint32_t alignment;         /* 0/1 = tanpa alignment, selain itu pangkat dua */
+    uint32_t resume;            /* lanjutkan dari journal pembuatan yang terputus */
+    const char* policy_file;    /* NULL = tanpa policy codec per file */
+    uint64_t max_memory;        /* batas byte buffer pack paralel; 0 = tanpa batas */
+} arch_create_options;
+
+ARCHPACKER_API const char* arch_last_error(void);
+ARCHPACKER_API void arch_default_options(arch_create_options* options);
+
+/* Membaca */
+ARCHPACKER_API int arch_open(const char* path, const char* passphrase, arch_archive** out);
+ARCHPACKER_API void arch_close(arch_archive* archive);
+ARCHPACKER_API uint32_t arch_entry_count(const arch_archive* archive);
+ARCHPACKER_API int arch_entry_at(const arch_archive* archive, uint32_t index, arch_entry_info* info);
+ARCHPACKER_API int arch_find(const arch_archive* archive, const char* name, uint32_t* index);
+/* Isi buffer dengan data entry. Jika capacity kurang, mengembalikan
+   ARCH_E_BUFFER dan out_size berisi ukuran yang dibutuhkan. Entry tombstone
+   mengembalikan ARCH_E_NOT_FOUND (sama seperti arch_find) dan entry delta
+   ARCH_E_INVALID, juga untuk arch_stream dan arch_acquire. */
+ARCHPACKER_API int arch_read(arch_archive* archive, uint32_t index,
+    void* buffer, size_t capacity, size_t* out_size);
+ARCHPACKER_API int arch_stream(arch_archive* archive, uint32_t index,
+    arch_write_fn write, void* user);
+
+/* Cache isi entry hasil decode, dibagi ke beberapa shard LRU. Panggil sebelum
+   archive dibaca dari banyak thread; budget_bytes 0 mematikan cache. Saat aktif,
+   arch_read, arch_stream dan arch_acquire mengambil data lewat cache. */
+ARCHPACKER_API int arch_set_cache(arch_archive* archive, uint64_t budget_bytes);
+ARCHPACKER_API int arch_get_cache_stats(const arch_archive* archive, arch_cache_stats* stats);
+/* Meminjam isi entry tanpa salinan. data tetap valid sampai arch_release,
+   walaupun entry sudah dikeluarkan dari cache. */
+ARCHPACKER_API int arch_acquire(arch_archive* archive, uint32_t index,
+    const void** data, size_t* size, arch_blob** blob);
+ARCHPACKER_API void arch_release(arch_blob* blob);
+/* Memanaskan cache untuk entry yang akan dibaca: readahead lalu decode di
+   thread latar belakang, fungsi langsung kembali. Butuh arch_set_cache;
+   nama yang tidak ada diabaikan (arch_find tetap melaporkannya). */
+ARCHPACKER_API int arch_prefetch(arch_archive* archive, const char* const* names, size_t count);
+/* Mencatat setiap entry yang dicari atau dibaca ke log_file (append), sebagai
+   input --layout-profile saat archive dibuat ulang. Panggil sebelum archive
+   dibaca dari banyak thread. */
+ARCHPACKER_API int arch_enable_access_log(arch_archive* archive, const char* log_file);
+
+/* Membuat. Jika ada file yang gagal dibaca atau dikemas, archive tetap ditulis
+   tanpa file tersebut tetapi fungsi mengembalikan ARCH_E_IO dan
+   arch_last_error berisi daftar file yang gagal. */
+ARCHPACKER_API int arch_create(const char* output, const char* const* inputs, size_t count,
+    const arch_create_options* options);
+ARCHPACKER_API int arch_writer_begin(const char* output, const arch_create_options* options,
+    arch_writer** out);
+ARCHPACKER_API int arch_writer_add_file(arch_writer* writer, const char* source_path,
+    const char* archive_path);
+/* Data disalin; buffer boleh dibebaskan setelah fungsi kembali */
+ARCHPACKER_API int arch_writer_add_buffer(arch_writer* writer, const char* archive_path,
+    const void* data, size_t size, uint64_t timestamp);
+/* Menulis archive lalu membebaskan writer, berhasil atau tidak */
+ARCHPACKER_API int arch_writer_finish(arch_writer* writer);
+ARCHPACKER_API void arch_writer_abort(arch_writer* writer);
+
+#ifdef __cplusplus
+}
+#endif
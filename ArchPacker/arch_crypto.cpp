@@ -25,15 +25,18 @@ namespace ArchCrypto {
             }
         }
 
-        
-        std::cout << "Generated Key (" << key_size << " bytes): ";
+        return key;
+    }
+
+    void PrintGeneratedKey(const std::string& passphrase) {
+        std::vector<uint8_t> key = GenerateKey(passphrase);
+
+        std::cout << "Generated Key (" << key.size() << " bytes): ";
         for (const auto& byte : key) {
             std::cout << std::hex << std::setw(2) << std::setfill('0')
                 << static_cast<int>(byte) << " ";
         }
         std::cout << std::dec << std::endl;
-
-        return key;
     }
 
     // Enkripsi menggunakan algoritma sederhana (XOR + shuffling)
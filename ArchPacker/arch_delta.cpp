@@ -0,0 +1,176 @@
+#include "stdafx.h"
+#include "arch_delta.h"
+#include "arch_utils.h"
+
+namespace {
+    const uint8_t OP_ADD = 0x00;
+    const uint8_t OP_COPY = 0x01;
+    const uint32_t HASH_MULTIPLIER = 0x01000193;
+
+    void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Hash polinomial atas satu jendela; bisa digeser satu byte dalam O(1)
+    uint32_t WindowHash(const uint8_t* data) {
+        uint32_t hash = 0;
+        for (size_t i = 0; i < ArchDelta::WINDOW_SIZE; ++i) {
+            hash = hash * HASH_MULTIPLIER + data[i];
+        }
+        return hash;
+    }
+
+    void EmitAdd(std::vector<uint8_t>& delta, const uint8_t* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        delta.push_back(OP_ADD);
+        PutVarint(delta, size);
+        delta.insert(delta.end(), data, data + size);
+    }
+
+    void EmitCopy(std::vector<uint8_t>& delta, size_t offset, size_t length) {
+        delta.push_back(OP_COPY);
+        PutVarint(delta, offset);
+        PutVarint(delta, length);
+    }
+}
+
+void ArchDelta::Encode(const uint8_t* base, size_t baseSize,
+    const uint8_t* target, size_t targetSize,
+    std::vector<uint8_t>& delta) {
+    DeltaHeader header;
+    header.magic = ArchConstants::DELTA_MAGIC;
+    header.baseSize = static_cast<uint32_t>(baseSize);
+    header.baseChecksum = ArchUtils::UpdateChecksum(0, base, baseSize);
+    header.targetSize = static_cast<uint32_t>(targetSize);
+    header.targetChecksum = ArchUtils::UpdateChecksum(0, target, targetSize);
+
+    delta.assign(reinterpret_cast<const uint8_t*>(&header),
+        reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+    if (baseSize < WINDOW_SIZE || targetSize < WINDOW_SIZE) {
+        EmitAdd(delta, target, targetSize);
+        return;
+    }
+
+    // Index base per blok WINDOW_SIZE yang tidak tumpang tindih: memori
+    // sebanding baseSize / WINDOW_SIZE, dan setiap rentang sama sepanjang
+    // minimal 2 * WINDOW_SIZE pasti memuat satu blok utuh
+    size_t blocks = baseSize / WINDOW_SIZE;
+    unsigned bits = 10;
+    while ((static_cast<size_t>(1) << bits) < blocks * 2 && bits < 30) {
+        ++bits;
+    }
+    std::vector<uint32_t> table(static_cast<size_t>(1) << bits, 0); // offset + 1, 0 = kosong
+    auto slotOf = [bits](uint32_t hash) { return (hash * 0x9E3779B1u) >> (32 - bits); };
+    for (size_t i = 0; i < blocks; ++i) {
+        uint32_t& slot = table[slotOf(WindowHash(base + i * WINDOW_SIZE))];
+        if (slot == 0) {
+            slot = static_cast<uint32_t>(i * WINDOW_SIZE + 1);
+        }
+    }
+
+    uint32_t outFactor = 1; // HASH_MULTIPLIER^(WINDOW_SIZE - 1)
+    for (size_t i = 1; i < WINDOW_SIZE; ++i) {
+        outFactor *= HASH_MULTIPLIER;
+    }
+
+    size_t literal = 0; // awal byte target yang belum tercakup operasi
+    size_t pos = 0;
+    uint32_t hash = WindowHash(target);
+    while (pos + WINDOW_SIZE <= targetSize) {
+        uint32_t candidate = table[slotOf(hash)];
+        if (candidate != 0 && memcmp(base + candidate - 1, target + pos, WINDOW_SIZE) == 0) {
+            size_t baseStart = candidate - 1;
+            size_t targetStart = pos;
+            while (targetStart > literal && baseStart > 0 &&
+                base[baseStart - 1] == target[targetStart - 1]) {
+                --baseStart;
+                --targetStart;
+            }
+            size_t length = pos + WINDOW_SIZE - targetStart;
+            while (targetStart + length < targetSize && baseStart + length < baseSize &&
+                base[baseStart + length] == target[targetStart + length]) {
+                ++length;
+            }
+
+            EmitAdd(delta, target + literal, targetStart - literal);
+            EmitCopy(delta, baseStart, length);
+            pos = literal = targetStart + length;
+            if (pos + WINDOW_SIZE <= targetSize) {
+                hash = WindowHash(target + pos);
+            }
+            continue;
+        }
+
+        if (pos + WINDOW_SIZE >= targetSize) {
+            break;
+        }
+        hash = (hash - target[pos] * outFactor) * HASH_MULTIPLIER + target[pos + WINDOW_SIZE];
+        ++pos;
+    }
+    EmitAdd(delta, target + literal, targetSize - literal);
+}
+
+bool ArchDelta::Apply(const uint8_t* base, size_t baseSize,
+    const uint8_t* delta, size_t deltaSize,
+    std::vector<uint8_t>& target) {
+    DeltaHeader header;
+    if (deltaSize < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, delta, sizeof(header));
+    if (header.magic != ArchConstants::DELTA_MAGIC || header.baseSize != baseSize ||
+        header.baseChecksum != ArchUtils::UpdateChecksum(0, base, baseSize)) {
+        return false;
+    }
+
+    target.clear();
+    target.reserve(header.targetSize);
+    const uint8_t* p = delta + sizeof(header);
+    const uint8_t* end = delta + deltaSize;
+    while (p < end) {
+        uint8_t op = *p++;
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        if (op == OP_ADD) {
+            if (!GetVarint(p, end, length) || length > static_cast<uint64_t>(end - p)) {
+                return false;
+            }
+            target.insert(target.end(), p, p + length);
+            p += length;
+        }
+        else if (op == OP_COPY) {
+            if (!GetVarint(p, end, offset) || !GetVarint(p, end, length) ||
+                offset > baseSize || length > baseSize - offset) {
+                return false;
+            }
+            target.insert(target.end(), base + offset, base + offset + length);
+        }
+        else {
+            return false;
+        }
+        if (target.size() > header.targetSize) {
+            return false;
+        }
+    }
+
+    return target.size() == header.targetSize &&
+        ArchUtils::UpdateChecksum(0, target.data(), target.size()) == header.targetChecksum;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+#include "arch_struct.h"
+
+// Delta biner gaya VCDIFF: target disusun dari operasi COPY (rentang byte dari
+// base) dan ADD (byte literal). Payload = DeltaHeader diikuti operasi:
+//   0x00 <len>            lalu len byte literal (ADD)
+//   0x01 <offset> <len>   salin base[offset, offset + len) (COPY)
+// Angka ditulis sebagai varint (7 bit per byte). Payload tetap dikompresi dan
+// dienkripsi seperti blob biasa, jadi literal ADD ikut mengecil.
+namespace ArchDelta {
+    // Blok base yang di-index; kecocokan lebih pendek dari ini tidak ditemukan
+    const size_t WINDOW_SIZE = 32;
+
+    // Mencari rentang yang sama dengan rolling hash atas jendela WINDOW_SIZE
+    // byte, lalu memperpanjang setiap kecocokan ke depan dan ke belakang.
+    void Encode(const uint8_t* base, size_t baseSize,
+        const uint8_t* target, size_t targetSize,
+        std::vector<uint8_t>& delta);
+
+    // Menyusun ulang target; false jika base tidak cocok dengan DeltaHeader,
+    // payload rusak, atau hasilnya gagal verifikasi checksum.
+    bool Apply(const uint8_t* base, size_t baseSize,
+        const uint8_t* delta, size_t deltaSize,
+        std::vector<uint8_t>& target);
+}
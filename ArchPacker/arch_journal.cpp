@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "arch_journal.h"
+#include "arch_utils.h"
+
+namespace {
+    const uint32_t JOURNAL_MAGIC = 0x4A435241;    // 'ARCJ' in little-endian
+    const uint32_t CHECKPOINT_MAGIC = 0x4B435241; // 'ARCK' in little-endian
+    const uint32_t JOURNAL_VERSION = 1;
+    const uint32_t MAX_CHECKPOINT_ENTRIES = 1u << 24;
+
+#pragma pack(push, 1)
+    struct JournalHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t fingerprint;
+        uint32_t reserved;
+    };
+
+    // Diikuti entryCount FileEntry yang selesai sejak checkpoint sebelumnya
+    struct CheckpointRecord {
+        uint32_t magic;
+        uint32_t itemsDone;
+        uint32_t entryCount;
+        uint32_t deltaFiles;
+        uint32_t unchangedFiles;
+        uint64_t writePos;
+        uint64_t paddingBytes;
+        uint32_t checksum;      // CRC32 record (checksum = 0) dan entry-nya
+    };
+#pragma pack(pop)
+
+    uint32_t RecordChecksum(CheckpointRecord record, const FileEntry* entries) {
+        record.checksum = 0;
+        uLong crc = crc32(0, reinterpret_cast<const Bytef*>(&record), sizeof(record));
+        return crc32(crc, reinterpret_cast<const Bytef*>(entries),
+            static_cast<uInt>(record.entryCount * sizeof(FileEntry)));
+    }
+}
+
+ArchJournal::ArchJournal()
+    : m_file(INVALID_HANDLE_VALUE), m_dataFile(INVALID_HANDLE_VALUE),
+    m_position(0), m_savedEntries(0) {}
+
+ArchJournal::~ArchJournal() {
+    Close();
+}
+
+void ArchJournal::Close() {
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    if (m_dataFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_dataFile);
+        m_dataFile = INVALID_HANDLE_VALUE;
+    }
+}
+
+void ArchJournal::Open(const std::string& path, const std::string& dataFile,
+    uint32_t fingerprint, bool resume, State& state) {
+    Close();
+    state = State();
+    m_path = path;
+    m_dataPath = dataFile;
+    m_position = 0;
+    m_savedEntries = 0;
+
+    if (resume) {
+        m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE) {
+        JournalHeader header;
+        size_t got = 0;
+        if (!ArchUtils::ReadAt(m_file, 0, &header, sizeof(header), &got) ||
+            got != sizeof(header) || header.magic != JOURNAL_MAGIC) {
+            throw std::runtime_error("Journal rusak: " + path);
+        }
+        if (header.fingerprint != fingerprint) {
+            throw std::runtime_error("Journal " + path + " dibuat untuk input atau opsi yang berbeda");
+        }
+
+        m_position = sizeof(header);
+        while (true) {
+            CheckpointRecord record;
+            if (!ArchUtils::ReadAt(m_file, m_position, &record, sizeof(record), &got) ||
+                got != sizeof(record) || record.magic != CHECKPOINT_MAGIC ||
+                record.entryCount > MAX_CHECKPOINT_ENTRIES) {
+                break;
+            }
+            std::vector<FileEntry> added(record.entryCount);
+            size_t bytes = added.size() * sizeof(FileEntry);
+            if (!ArchUtils::ReadAt(m_file, m_position + sizeof(record), added.data(), bytes, &got) ||
+                got != bytes || RecordChecksum(record, added.data()) != record.checksum) {
+                break;
+            }
+
+            state.itemsDone = record.itemsDone;
+            state.writePos = record.writePos;
+            state.paddingBytes = record.paddingBytes;
+            state.deltaFiles = record.deltaFiles;
+            state.unchangedFiles = record.unchangedFiles;
+            state.entries.insert(state.entries.end(), added.begin(), added.end());
+            m_position += sizeof(record) + bytes;
+        }
+        m_savedEntries = state.entries.size();
+
+        // Sisa checkpoint yang terpotong dibuang agar record berikutnya menyambung
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(m_position);
+        if (!SetFilePointerEx(m_file, end, NULL, FILE_BEGIN) || !SetEndOfFile(m_file)) {
+            throw std::runtime_error("Gagal memotong journal: " + ArchUtils::GetLastErrorString());
+        }
+        return;
+    }
+
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Gagal membuat journal " + path + ": " + ArchUtils::GetLastErrorString());
+    }
+    JournalHeader header = { JOURNAL_MAGIC, JOURNAL_VERSION, fingerprint, 0 };
+    if (!ArchUtils::WriteAt(m_file, 0, &header, sizeof(header)) || !FlushFileBuffers(m_file)) {
+        throw std::runtime_error("Gagal menulis journal: " + ArchUtils::GetLastErrorString());
+    }
+    m_position = sizeof(header);
+}
+
+void ArchJournal::Checkpoint(const State& state) {
+    // Data harus sudah aman di disk sebelum journal menunjuk ke sana
+    if (m_dataFile == INVALID_HANDLE_VALUE) {
+        m_dataFile = CreateFileA(m_dataPath.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (m_dataFile == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Gagal membuka " + m_dataPath + ": " + ArchUtils::GetLastErrorString());
+        }
+    }
+    if (!FlushFileBuffers(m_dataFile)) {
+        throw std::runtime_error("Gagal menulis " + m_dataPath + " ke disk: " + ArchUtils::GetLastErrorString());
+    }
+
+    CheckpointRecord record;
+    record.magic = CHECKPOINT_MAGIC;
+    record.itemsDone = state.itemsDone;
+    record.entryCount = static_cast<uint32_t>(state.entries.size() - m_savedEntries);
+    record.deltaFiles = state.deltaFiles;
+    record.unchangedFiles = state.unchangedFiles;
+    record.writePos = state.writePos;
+    record.paddingBytes = state.paddingBytes;
+    const FileEntry* added = state.entries.data() + m_savedEntries;
+    record.checksum = RecordChecksum(record, added);
+
+    std::vector<uint8_t> buffer(sizeof(record) + record.entryCount * sizeof(FileEntry));
+    memcpy(buffer.data(), &record, sizeof(record));
+    if (record.entryCount > 0) {
+        memcpy(buffer.data() + sizeof(record), added, record.entryCount * sizeof(FileEntry));
+    }
+    if (!ArchUtils::WriteAt(m_file, m_position, buffer.data(), buffer.size()) || !FlushFileBuffers(m_file)) {
+        throw std::runtime_error("Gagal menulis journal: " + ArchUtils::GetLastErrorString());
+    }
+    m_position += buffer.size();
+    m_savedEntries = state.entries.size();
+}
+
+void ArchJournal::Remove() {
+    Close();
+    if (!m_path.empty()) {
+        DeleteFileA(m_path.c_str());
+    }
+}
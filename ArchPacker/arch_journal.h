@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "arch_struct.h"
+
+// Journal pembuatan archive di samping file .part. Setiap checkpoint mencatat
+// entry yang sudah selesai ditulis beserta posisi tulis, sehingga pembuatan
+// yang terputus bisa dilanjutkan tanpa mengompresi ulang file yang sudah jadi.
+// Checkpoint hanya ditambahkan di belakang; checkpoint terakhir yang terpotong
+// (crash saat menulis journal) diabaikan saat dibaca.
+class ArchJournal {
+public:
+    // Checkpoint ditulis setelah sebanyak ini data baru atau selang waktu ini
+    static constexpr uint64_t CHECKPOINT_BYTES = 64ull << 20;
+    static constexpr uint32_t CHECKPOINT_SECONDS = 10;
+
+    struct State {
+        uint32_t itemsDone = 0;     // item manifest yang sudah diproses
+        uint64_t writePos = 0;      // akhir data yang sah di file .part
+        uint64_t paddingBytes = 0;
+        uint32_t deltaFiles = 0;
+        uint32_t unchangedFiles = 0;
+        std::vector<FileEntry> entries;
+    };
+
+    ArchJournal();
+    ~ArchJournal();
+
+    // Dengan resume, checkpoint utuh terakhir dibaca ke state dan journal
+    // dilanjutkan di belakangnya; jika journal belum ada, state tetap kosong.
+    // Tanpa resume journal dibuat ulang. fingerprint mewakili manifest dan
+    // opsi; journal dengan fingerprint lain ditolak dengan std::runtime_error.
+    // dataFile adalah file .part yang di-flush ke disk sebelum setiap checkpoint
+    // (dibuka saat checkpoint pertama, jadi boleh belum ada saat Open).
+    void Open(const std::string& path, const std::string& dataFile,
+        uint32_t fingerprint, bool resume, State& state);
+    // Mencatat state; hanya entry yang belum ada di checkpoint sebelumnya
+    // yang ditulis. Data di file .part harus sudah di-flush oleh pemanggil.
+    void Checkpoint(const State& state);
+    // Dipanggil setelah archive selesai di-rename ke nama akhirnya
+    void Remove();
+
+private:
+    void Close();
+
+    std::string m_path;
+    std::string m_dataPath;
+    HANDLE m_file;
+    HANDLE m_dataFile;
+    uint64_t m_position;
+    size_t m_savedEntries;
+
+    ArchJournal(const ArchJournal&) = delete;
+    ArchJournal& operator=(const ArchJournal&) = delete;
+};
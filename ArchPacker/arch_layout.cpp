@@ -0,0 +1,109 @@
+#include "stdafx.h"
+#include "arch_layout.h"
+#include <unordered_map>
+#include <numeric>
+
+namespace {
+    size_t FindRoot(std::vector<size_t>& parent, size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+}
+
+size_t ArchLayout::ApplyProfile(const std::string& profileFile, std::vector<ManifestEntry>& manifest) {
+    std::ifstream in(profileFile);
+    if (!in) {
+        throw std::runtime_error("Gagal membuka layout profile: " + profileFile);
+    }
+
+    std::unordered_map<std::string, size_t> indexByName;
+    indexByName.reserve(manifest.size());
+    for (size_t i = 0; i < manifest.size(); ++i) {
+        indexByName.emplace(manifest[i].archivePath, i);
+    }
+
+    const uint64_t notAccessed = UINT64_MAX;
+    std::vector<uint64_t> firstAccess(manifest.size(), notAccessed);
+    std::vector<size_t> parent(manifest.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    // Hanya akses pertama per file di setiap sesi yang dipakai
+    std::vector<uint8_t> seenInSession(manifest.size(), 0);
+    std::vector<size_t> sessionFiles;
+    uint64_t lastTime = 0;
+    size_t burstHead = SIZE_MAX;
+
+    auto endSession = [&]() {
+        for (size_t index : sessionFiles) {
+            seenInSession[index] = 0;
+        }
+        sessionFiles.clear();
+        burstHead = SIZE_MAX;
+    };
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        if (line[0] == '#') {
+            endSession();
+            continue;
+        }
+
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) continue;
+
+        uint64_t time = std::strtoull(line.c_str(), nullptr, 10);
+        auto found = indexByName.find(line.substr(tab + 1));
+        if (found == indexByName.end()) continue;
+
+        size_t index = found->second;
+        if (seenInSession[index]) continue;
+        seenInSession[index] = 1;
+        sessionFiles.push_back(index);
+
+        firstAccess[index] = std::min(firstAccess[index], time);
+
+        if (burstHead == SIZE_MAX || time - lastTime > BURST_GAP_MS) {
+            burstHead = index;
+        }
+        else {
+            parent[FindRoot(parent, index)] = FindRoot(parent, burstHead);
+        }
+        lastTime = time;
+    }
+
+    std::vector<uint64_t> clusterKey(manifest.size(), notAccessed);
+    size_t profiled = 0;
+    for (size_t i = 0; i < manifest.size(); ++i) {
+        if (firstAccess[i] == notAccessed) continue;
+        size_t root = FindRoot(parent, i);
+        clusterKey[root] = std::min(clusterKey[root], firstAccess[i]);
+        profiled++;
+    }
+
+    // Kunci urut: (akses pertama cluster, cluster, akses pertama file)
+    std::vector<std::pair<uint64_t, size_t>> sortKey(manifest.size(), { notAccessed, SIZE_MAX });
+    for (size_t i = 0; i < manifest.size(); ++i) {
+        if (firstAccess[i] == notAccessed) continue;
+        size_t root = FindRoot(parent, i);
+        sortKey[i] = { clusterKey[root], root };
+    }
+
+    std::vector<size_t> order(manifest.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (sortKey[a] != sortKey[b]) return sortKey[a] < sortKey[b];
+        return firstAccess[a] < firstAccess[b];
+    });
+
+    std::vector<ManifestEntry> ordered;
+    ordered.reserve(manifest.size());
+    for (size_t index : order) {
+        ordered.push_back(std::move(manifest[index]));
+    }
+    manifest.swap(ordered);
+    return profiled;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "arch_manifest.h"
+
+namespace ArchLayout {
+    // Akses yang berjarak kurang dari ini dianggap satu burst (dimuat bersama)
+    const uint64_t BURST_GAP_MS = 500;
+
+    // Mengurutkan manifest memakai access log dari ArchReader::EnableAccessLog.
+    // File diurutkan menurut waktu akses pertama relatif terhadap awal sesi;
+    // file yang pernah dimuat dalam burst yang sama digabung menjadi satu
+    // cluster agar blob-nya bersebelahan. File tanpa catatan akses ditaruh
+    // di belakang dengan urutan aslinya. Mengembalikan jumlah file terprofil.
+    size_t ApplyProfile(const std::string& profileFile, std::vector<ManifestEntry>& manifest);
+}
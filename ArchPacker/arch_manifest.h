@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Satu file input yang akan dipak: lokasi di disk, path di dalam archive,
+// serta ukuran dan waktu modifikasi (detik Unix) dari hasil scan
+struct ManifestEntry {
+    std::string sourcePath;
+    std::string archivePath;
+    uint64_t size = 0;
+    uint64_t timestamp = 0;
+    // Jika diisi, isi file diambil dari buffer ini dan sourcePath diabaikan
+    std::shared_ptr<const std::vector<uint8_t>> data;
+    // Entry tombstone: menandai archivePath sebagai terhapus, tanpa isi
+    bool tombstone = false;
+};
@@ -0,0 +1,454 @@
+#include "stdafx.h"
+#include "arch_mount.h"
+#include <objbase.h>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+    std::wstring Widen(const std::string& text) {
+        if (text.empty()) {
+            return std::wstring();
+        }
+        int length = MultiByteToWideChar(CP_ACP, 0, text.data(), static_cast<int>(text.size()), NULL, 0);
+        std::wstring result(length, L'\0');
+        MultiByteToWideChar(CP_ACP, 0, text.data(), static_cast<int>(text.size()), &result[0], length);
+        return result;
+    }
+
+    LARGE_INTEGER UnixToFileTime(uint64_t seconds) {
+        // FILETIME dihitung dalam satuan 100 ns sejak 1601-01-01
+        LARGE_INTEGER time;
+        time.QuadPart = static_cast<LONGLONG>((seconds + 11644473600ull) * 10000000ull);
+        return time;
+    }
+
+    // ProjFS membaca dalam potongan besar; buffer dibatasi agar memori tetap kecil
+    const UINT32 WRITE_CHUNK = 4 * 1024 * 1024;
+
+    // Hanya placeholder milik ProjFS yang dihapus; file yang dibuat atau diubah
+    // pengguna di mount point dibiarkan dan dicatat. Mengembalikan true bila folder kosong
+    bool RemoveProjected(const fs::path& directory, std::vector<std::string>& kept) {
+        std::error_code ec;
+        std::vector<fs::path> children;
+        for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            children.push_back(it->path());
+        }
+        if (ec) {
+            kept.push_back(directory.string());
+            return false;
+        }
+
+        bool empty = true;
+        for (const fs::path& child : children) {
+            PRJ_FILE_STATE state;
+            bool projected = SUCCEEDED(PrjGetOnDiskFileState(child.wstring().c_str(), &state)) &&
+                (state & (PRJ_FILE_STATE_PLACEHOLDER | PRJ_FILE_STATE_HYDRATED_PLACEHOLDER | PRJ_FILE_STATE_TOMBSTONE)) != 0;
+
+            if (fs::is_directory(child, ec) && !fs::is_symlink(child, ec)) {
+                // Folder placeholder bisa berisi file buatan pengguna; isinya diperiksa dulu
+                if (RemoveProjected(child, kept) && projected && fs::remove(child, ec)) {
+                    continue;
+                }
+                if (!projected) {
+                    kept.push_back(child.string());
+                }
+            } else if (projected && fs::remove(child, ec)) {
+                continue;
+            } else {
+                kept.push_back(child.string());
+            }
+            empty = false;
+        }
+        return empty;
+    }
+}
+
+ArchMount::ArchMount()
+    : m_cacheBudget(256 * 1024 * 1024), m_context(nullptr), m_createdMountPoint(false) {
+    m_archiveTime.QuadPart = 0;
+}
+
+ArchMount::~ArchMount() {
+    Stop();
+}
+
+void ArchMount::SetEncryptionKey(const std::string& passphrase) {
+    m_encryptionKey = passphrase.empty() ? std::vector<uint8_t>() : ArchCrypto::GenerateKey(passphrase);
+}
+
+bool ArchMount::Start(const std::string& archiveFile, const std::string& mountPoint) {
+    Stop();
+
+    if (!m_reader.Open(archiveFile)) {
+        m_error = m_reader.GetError();
+        return false;
+    }
+    m_reader.EnableCache(m_cacheBudget);
+    if (!m_accessLog.empty() && !m_reader.EnableAccessLog(m_accessLog)) {
+        m_error = m_reader.GetError();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < m_reader.GetEntryCount(); ++i) {
+        if (m_reader.GetEntry(i).encryptionType == 1 && m_encryptionKey.empty()) {
+            m_error = "Archive berisi file terenkripsi tetapi passphrase tidak diberikan";
+            return false;
+        }
+    }
+
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (GetFileAttributesExA(archiveFile.c_str(), GetFileExInfoStandard, &attributes)) {
+        m_archiveTime.LowPart = attributes.ftLastWriteTime.dwLowDateTime;
+        m_archiveTime.HighPart = static_cast<LONG>(attributes.ftLastWriteTime.dwHighDateTime);
+    }
+
+    if (!BuildTree()) {
+        return false;
+    }
+
+    try {
+        std::error_code ec;
+        if (fs::exists(mountPoint, ec)) {
+            if (!fs::is_directory(mountPoint, ec) || !fs::is_empty(mountPoint, ec)) {
+                m_error = "Mount point harus folder kosong atau belum ada: " + mountPoint;
+                return false;
+            }
+            m_createdMountPoint = false;
+        }
+        else {
+            if (!CreateDirectoryA(mountPoint.c_str(), NULL)) {
+                m_error = "Gagal membuat mount point: " + ArchUtils::GetLastErrorString();
+                return false;
+            }
+            m_createdMountPoint = true;
+        }
+        m_mountPoint = mountPoint;
+    }
+    catch (const std::exception& e) {
+        m_error = e.what();
+        return false;
+    }
+
+    std::wstring root = Widen(m_mountPoint);
+    GUID instanceId;
+    HRESULT hr = CoCreateGuid(&instanceId);
+    if (SUCCEEDED(hr)) {
+        hr = PrjMarkDirectoryAsPlaceholder(root.c_str(), NULL, NULL, &instanceId);
+    }
+    if (FAILED(hr)) {
+        m_error = "Gagal menyiapkan mount point ProjFS (fitur Projected File System aktif?), HRESULT " +
+            std::to_string(static_cast<long>(hr));
+        Stop();
+        return false;
+    }
+
+    PRJ_CALLBACKS callbacks = {};
+    callbacks.StartDirectoryEnumerationCallback = &ArchMount::OnStartEnumeration;
+    callbacks.GetDirectoryEnumerationCallback = &ArchMount::OnGetEnumeration;
+    callbacks.EndDirectoryEnumerationCallback = &ArchMount::OnEndEnumeration;
+    callbacks.GetPlaceholderInfoCallback = &ArchMount::OnGetPlaceholderInfo;
+    callbacks.GetFileDataCallback = &ArchMount::OnGetFileData;
+    callbacks.NotificationCallback = &ArchMount::OnNotification;
+
+    // Hapus, rename dan perubahan isi file ditolak agar mount tetap read-only
+    PRJ_NOTIFICATION_MAPPING mapping = {};
+    mapping.NotificationRoot = L"";
+    mapping.NotificationBitMask = PRJ_NOTIFY_PRE_DELETE | PRJ_NOTIFY_PRE_RENAME |
+        PRJ_NOTIFY_PRE_SET_HARDLINK | PRJ_NOTIFY_FILE_PRE_CONVERT_TO_FULL;
+    PRJ_STARTVIRTUALIZING_OPTIONS options = {};
+    options.NotificationMappings = &mapping;
+    options.NotificationMappingsCount = 1;
+
+    hr = PrjStartVirtualizing(root.c_str(), &callbacks, this, &options, &m_context);
+    if (FAILED(hr)) {
+        m_context = nullptr;
+        m_error = "Gagal memulai ProjFS, HRESULT " + std::to_string(static_cast<long>(hr));
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void ArchMount::Stop() {
+    if (m_context) {
+        PrjStopVirtualizing(m_context);
+        m_context = nullptr;
+    }
+
+    // File yang sudah dibaca tersimpan sebagai salinan lokal di mount point;
+    // dibuang agar folder kembali seperti sebelum mount
+    if (!m_mountPoint.empty()) {
+        std::vector<std::string> kept;
+        if (RemoveProjected(m_mountPoint, kept)) {
+            std::error_code ec;
+            if (m_createdMountPoint) {
+                fs::remove(m_mountPoint, ec);
+            }
+            if (ec) {
+                std::cerr << "Warning: Gagal membersihkan mount point " << m_mountPoint << ": " << ec.message() << "\n";
+            }
+        } else {
+            std::cerr << "Warning: " << kept.size() << " file di mount point bukan milik archive dan tidak dihapus:\n";
+            for (const std::string& path : kept) {
+                std::cerr << "  " << path << "\n";
+            }
+        }
+        m_mountPoint.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_enumLock);
+        m_enumerations.clear();
+    }
+    m_nodes.clear();
+    m_paths.clear();
+    m_reader.Close();
+}
+
+bool ArchMount::BuildTree() {
+    m_nodes.clear();
+    m_paths.clear();
+    m_nodes.push_back(Node{ L"", L"", true, 0, {} });
+    m_paths[L""] = 0;
+
+    for (uint32_t i = 0; i < m_reader.GetEntryCount(); ++i) {
+        const FileEntry& entry = m_reader.GetEntry(i);
+        if (entry.flags & FileEntry::FLAG_TOMBSTONE) {
+            continue;
+        }
+        if (entry.flags & FileEntry::FLAG_DELTA) {
+            std::cerr << "Warning: Entry delta dilewati (butuh archive base): "
+                << entry.filename << "\n";
+            continue;
+        }
+        std::wstring name = Widen(std::string(entry.filename,
+            strnlen(entry.filename, ArchConstants::MAX_FILENAME_LENGTH)));
+        std::replace(name.begin(), name.end(), L'/', L'\\');
+
+        uint32_t parent = 0;
+        size_t start = 0;
+        bool skipped = false;
+        while (!skipped) {
+            size_t end = name.find(L'\\', start);
+            bool leaf = end == std::wstring::npos;
+            std::wstring part = name.substr(start, leaf ? std::wstring::npos : end - start);
+            if (part.empty() || part == L"." || part == L"..") {
+                if (leaf) {
+                    skipped = true;
+                }
+                else {
+                    start = end + 1;
+                }
+                continue;
+            }
+
+            std::wstring path = m_nodes[parent].path.empty() ? part : m_nodes[parent].path + L"\\" + part;
+            auto found = m_paths.find(path);
+            if (found != m_paths.end()) {
+                // Nama kembar atau bentrok file/folder: entry pertama yang dipakai
+                if (leaf || !m_nodes[found->second].directory) {
+                    skipped = true;
+                    break;
+                }
+                parent = found->second;
+            }
+            else {
+                uint32_t index = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.push_back(Node{ part, path, !leaf, leaf ? i : 0, {} });
+                m_nodes[parent].children.push_back(index);
+                m_paths[path] = index;
+                parent = index;
+            }
+            if (leaf) {
+                break;
+            }
+            start = end + 1;
+        }
+        if (skipped) {
+            std::cerr << "Warning: Entry dilewati karena nama bentrok atau tidak valid: " << entry.filename << "\n";
+        }
+    }
+
+    // ProjFS mensyaratkan hasil enumerasi terurut sesuai PrjFileNameCompare
+    for (auto& node : m_nodes) {
+        std::sort(node.children.begin(), node.children.end(), [this](uint32_t a, uint32_t b) {
+            return PrjFileNameCompare(m_nodes[a].name.c_str(), m_nodes[b].name.c_str()) < 0;
+        });
+    }
+    return true;
+}
+
+const ArchMount::Node* ArchMount::Lookup(PCWSTR path) const {
+    auto found = m_paths.find(path ? std::wstring(path) : std::wstring());
+    return found == m_paths.end() ? nullptr : &m_nodes[found->second];
+}
+
+void ArchMount::FillBasicInfo(const Node& node, PRJ_FILE_BASIC_INFO& info) const {
+    info.IsDirectory = node.directory;
+    if (node.directory) {
+        info.FileSize = 0;
+        info.FileAttributes = FILE_ATTRIBUTE_DIRECTORY;
+        info.CreationTime = info.LastAccessTime = info.LastWriteTime = info.ChangeTime = m_archiveTime;
+        return;
+    }
+
+    const FileEntry& entry = m_reader.GetEntry(node.entry);
+    info.FileSize = entry.size;
+    info.FileAttributes = FILE_ATTRIBUTE_READONLY;
+    info.CreationTime = info.LastAccessTime = info.LastWriteTime = info.ChangeTime =
+        entry.timestamp ? UnixToFileTime(entry.timestamp) : m_archiveTime;
+}
+
+HRESULT ArchMount::StartEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id) {
+    const Node* node = Lookup(data->FilePathName);
+    if (!node || !node->directory) {
+        return HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND);
+    }
+
+    std::lock_guard<std::mutex> lock(m_enumLock);
+    m_enumerations[*id] = Enumeration{ static_cast<uint32_t>(node - m_nodes.data()), 0, std::wstring() };
+    return S_OK;
+}
+
+HRESULT ArchMount::GetEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id,
+    PCWSTR searchExpression, PRJ_DIR_ENTRY_BUFFER_HANDLE buffer) {
+    std::lock_guard<std::mutex> lock(m_enumLock);
+    auto found = m_enumerations.find(*id);
+    if (found == m_enumerations.end()) {
+        return E_INVALIDARG;
+    }
+
+    // Pola pencarian hanya diberikan pada panggilan pertama atau saat restart
+    Enumeration& session = found->second;
+    if (session.filter.empty() || (data->Flags & PRJ_CB_DATA_FLAG_ENUM_RESTART_SCAN)) {
+        session.position = 0;
+        session.filter = searchExpression ? searchExpression : L"*";
+    }
+
+    const Node& directory = m_nodes[session.directory];
+    bool added = false;
+    for (; session.position < directory.children.size(); ++session.position) {
+        const Node& child = m_nodes[directory.children[session.position]];
+        if (!PrjFileNameMatch(child.name.c_str(), session.filter.c_str())) {
+            continue;
+        }
+
+        PRJ_FILE_BASIC_INFO info = {};
+        FillBasicInfo(child, info);
+        HRESULT hr = PrjFillDirEntryBuffer(child.name.c_str(), &info, buffer);
+        if (FAILED(hr)) {
+            // Buffer penuh: sisanya dikirim pada panggilan berikutnya
+            return added ? S_OK : hr;
+        }
+        added = true;
+    }
+    return S_OK;
+}
+
+HRESULT ArchMount::EndEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id) {
+    std::lock_guard<std::mutex> lock(m_enumLock);
+    m_enumerations.erase(*id);
+    return S_OK;
+}
+
+HRESULT ArchMount::GetPlaceholderInfo(const PRJ_CALLBACK_DATA* data) {
+    const Node* node = Lookup(data->FilePathName);
+    if (!node) {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+
+    PRJ_PLACEHOLDER_INFO info = {};
+    FillBasicInfo(*node, info.FileBasicInfo);
+    // Path ditulis dengan huruf besar/kecil sesuai archive, bukan sesuai permintaan
+    return PrjWritePlaceholderInfo(m_context, node->path.c_str(), &info, sizeof(info));
+}
+
+HRESULT ArchMount::GetFileData(const PRJ_CALLBACK_DATA* data, UINT64 byteOffset, UINT32 length) {
+    const Node* node = Lookup(data->FilePathName);
+    if (!node || node->directory) {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+    const FileEntry& entry = m_reader.GetEntry(node->entry);
+    if (byteOffset > entry.size || length > entry.size - byteOffset) {
+        return E_INVALIDARG;
+    }
+    // File besar diminta per rentang; cukup dicatat sekali di awal
+    if (byteOffset == 0) {
+        m_reader.LogAccess(entry);
+    }
+
+    // Entry tanpa kompresi dan enkripsi dibaca langsung per rentang; selainnya
+    // di-decode utuh sekali lalu dilayani dari cache
+    bool direct = entry.compressionType == 0 && entry.encryptionType == 0;
+    EntryCache::Handle decoded;
+    if (!direct) {
+        decoded = m_reader.ReadEntryData(entry, m_encryptionKey);
+        if (!decoded) {
+            std::cerr << "Error: " << m_reader.GetError() << "\n";
+            return HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT);
+        }
+    }
+
+    void* buffer = PrjAllocateAlignedBuffer(m_context, std::min(length, WRITE_CHUNK));
+    if (!buffer) {
+        return E_OUTOFMEMORY;
+    }
+
+    HRESULT hr = S_OK;
+    UINT64 position = byteOffset;
+    UINT64 end = byteOffset + length;
+    while (position < end && SUCCEEDED(hr)) {
+        UINT32 chunk = static_cast<UINT32>(std::min<UINT64>(WRITE_CHUNK, end - position));
+        if (direct) {
+            if (!m_reader.ReadStored(entry, static_cast<uint32_t>(position), chunk, static_cast<uint8_t*>(buffer))) {
+                std::cerr << "Error: " << m_reader.GetError() << "\n";
+                hr = HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT);
+                break;
+            }
+        }
+        else {
+            memcpy(buffer, decoded->data() + position, chunk);
+        }
+        hr = PrjWriteFileData(m_context, &data->DataStreamId, buffer, position, chunk);
+        position += chunk;
+    }
+
+    PrjFreeAlignedBuffer(buffer);
+    return hr;
+}
+
+HRESULT CALLBACK ArchMount::OnStartEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id) {
+    return static_cast<ArchMount*>(data->InstanceContext)->StartEnumeration(data, id);
+}
+
+HRESULT CALLBACK ArchMount::OnGetEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id,
+    PCWSTR searchExpression, PRJ_DIR_ENTRY_BUFFER_HANDLE buffer) {
+    return static_cast<ArchMount*>(data->InstanceContext)->GetEnumeration(data, id, searchExpression, buffer);
+}
+
+HRESULT CALLBACK ArchMount::OnEndEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id) {
+    return static_cast<ArchMount*>(data->InstanceContext)->EndEnumeration(data, id);
+}
+
+HRESULT CALLBACK ArchMount::OnGetPlaceholderInfo(const PRJ_CALLBACK_DATA* data) {
+    return static_cast<ArchMount*>(data->InstanceContext)->GetPlaceholderInfo(data);
+}
+
+HRESULT CALLBACK ArchMount::OnGetFileData(const PRJ_CALLBACK_DATA* data, UINT64 byteOffset, UINT32 length) {
+    return static_cast<ArchMount*>(data->InstanceContext)->GetFileData(data, byteOffset, length);
+}
+
+HRESULT CALLBACK ArchMount::OnNotification(const PRJ_CALLBACK_DATA* data, BOOLEAN isDirectory,
+    PRJ_NOTIFICATION notification, PCWSTR destinationFileName,
+    PRJ_NOTIFICATION_PARAMETERS* parameters) {
+    switch (notification) {
+    case PRJ_NOTIFICATION_PRE_DELETE:
+    case PRJ_NOTIFICATION_PRE_RENAME:
+    case PRJ_NOTIFICATION_PRE_SET_HARDLINK:
+    case PRJ_NOTIFICATION_FILE_PRE_CONVERT_TO_FULL:
+        return HRESULT_FROM_WIN32(ERROR_ACCESS_DENIED);
+    default:
+        return S_OK;
+    }
+}
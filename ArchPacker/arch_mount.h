@@ -0,0 +1,92 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <projectedfslib.h>
+#include "arch_reader.h"
+
+// Menampilkan isi archive sebagai folder read-only lewat Windows Projected
+// File System (ProjFS), padanan FUSE di Windows. Struktur folder dibangun dari
+// index; isi file baru dibaca dan di-decode saat pertama kali diakses.
+class ArchMount {
+public:
+    ArchMount();
+    ~ArchMount();
+
+    void SetEncryptionKey(const std::string& passphrase);
+    // Anggaran cache entry hasil decode (default 256 MB, 0 = tanpa cache)
+    void SetCacheBudget(size_t bytes) { m_cacheBudget = bytes; }
+    // File yang dibuka lewat mount dicatat ke access log (lihat ArchReader)
+    void SetAccessLog(const std::string& logFile) { m_accessLog = logFile; }
+
+    // mountPoint harus belum ada atau folder kosong; placeholder dari archive dihapus lagi saat Stop,
+    // file yang dibuat pengguna di dalamnya dibiarkan
+    bool Start(const std::string& archiveFile, const std::string& mountPoint);
+    void Stop();
+    const std::string& GetError() const { return m_error; }
+
+private:
+    struct Node {
+        std::wstring name;
+        std::wstring path;              // relatif terhadap mount point, pemisah '\'
+        bool directory;
+        uint32_t entry;                 // index FileEntry, hanya untuk file
+        std::vector<uint32_t> children; // urut PrjFileNameCompare
+    };
+    struct Enumeration {
+        uint32_t directory;
+        size_t position;
+        std::wstring filter;
+    };
+    struct PathLess {
+        bool operator()(const std::wstring& a, const std::wstring& b) const {
+            return _wcsicmp(a.c_str(), b.c_str()) < 0;
+        }
+    };
+    struct GuidLess {
+        bool operator()(const GUID& a, const GUID& b) const {
+            return memcmp(&a, &b, sizeof(GUID)) < 0;
+        }
+    };
+
+    bool BuildTree();
+    const Node* Lookup(PCWSTR path) const;
+    void FillBasicInfo(const Node& node, PRJ_FILE_BASIC_INFO& info) const;
+
+    HRESULT StartEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id);
+    HRESULT GetEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id,
+        PCWSTR searchExpression, PRJ_DIR_ENTRY_BUFFER_HANDLE buffer);
+    HRESULT EndEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id);
+    HRESULT GetPlaceholderInfo(const PRJ_CALLBACK_DATA* data);
+    HRESULT GetFileData(const PRJ_CALLBACK_DATA* data, UINT64 byteOffset, UINT32 length);
+
+    static HRESULT CALLBACK OnStartEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id);
+    static HRESULT CALLBACK OnGetEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id,
+        PCWSTR searchExpression, PRJ_DIR_ENTRY_BUFFER_HANDLE buffer);
+    static HRESULT CALLBACK OnEndEnumeration(const PRJ_CALLBACK_DATA* data, const GUID* id);
+    static HRESULT CALLBACK OnGetPlaceholderInfo(const PRJ_CALLBACK_DATA* data);
+    static HRESULT CALLBACK OnGetFileData(const PRJ_CALLBACK_DATA* data, UINT64 byteOffset, UINT32 length);
+    static HRESULT CALLBACK OnNotification(const PRJ_CALLBACK_DATA* data, BOOLEAN isDirectory,
+        PRJ_NOTIFICATION notification, PCWSTR destinationFileName,
+        PRJ_NOTIFICATION_PARAMETERS* parameters);
+
+    ArchReader m_reader;
+    std::vector<uint8_t> m_encryptionKey;
+    size_t m_cacheBudget;
+    std::string m_accessLog;
+    std::vector<Node> m_nodes;          // m_nodes[0] = root
+    std::map<std::wstring, uint32_t, PathLess> m_paths;
+    LARGE_INTEGER m_archiveTime;
+
+    std::mutex m_enumLock;
+    std::map<GUID, Enumeration, GuidLess> m_enumerations;
+
+    PRJ_NAMESPACE_VIRTUALIZATION_CONTEXT m_context;
+    std::string m_mountPoint;
+    bool m_createdMountPoint;
+    std::string m_error;
+
+    ArchMount(const ArchMount&) = delete;
+    ArchMount& operator=(const ArchMount&) = delete;
+};
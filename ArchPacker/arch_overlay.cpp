@@ -0,0 +1,172 @@
+#include "stdafx.h"
+#include "arch_overlay.h"
+#include "arch_delta.h"
+
+ArchOverlay::ArchOverlay() {}
+ArchOverlay::~ArchOverlay() {}
+
+bool ArchOverlay::Open(const std::vector<std::string>& layers, const std::vector<std::string>& volumeDirs) {
+    Close();
+
+    if (layers.empty()) {
+        m_error = "Tidak ada archive untuk dibuka";
+        return false;
+    }
+
+    for (const auto& path : layers) {
+        std::unique_ptr<ArchReader> reader(new ArchReader());
+        if (!reader->Open(path, volumeDirs)) {
+            m_error = path + ": " + reader->GetError();
+            Close();
+            return false;
+        }
+        m_layers.push_back(std::move(reader));
+    }
+    m_index.reset(new MergedIndex());
+    return true;
+}
+
+const ArchOverlay::MergedIndex& ArchOverlay::GetIndex() const {
+    // Layer diproses dari base ke atas sehingga layer belakang menimpa. Di
+    // dalam satu layer entry dibaca mundur agar nama kembar memakai entry
+    // pertama, sama seperti ArchReader::FindEntry.
+    std::call_once(m_index->built, [this]() {
+        size_t totalEntries = 0;
+        for (const auto& layer : m_layers) {
+            totalEntries += layer->GetEntryCount();
+        }
+        m_index->entries.reserve(totalEntries);
+
+        for (uint32_t layerIndex = 0; layerIndex < m_layers.size(); ++layerIndex) {
+            const ArchReader& reader = *m_layers[layerIndex];
+            for (uint32_t i = reader.GetEntryCount(); i-- > 0; ) {
+                const FileEntry& entry = reader.GetEntry(i);
+                std::string_view name(entry.filename, strnlen(entry.filename, ArchConstants::MAX_FILENAME_LENGTH));
+
+                if (entry.flags & FileEntry::FLAG_TOMBSTONE) {
+                    m_index->entries.erase(name);
+                }
+                else {
+                    m_index->entries[name] = Location{ layerIndex, &entry };
+                }
+            }
+        }
+    });
+    return *m_index;
+}
+
+bool ArchOverlay::EnableAccessLog(const std::string& logFile) {
+    if (m_layers.empty() || !m_layers.front()->EnableAccessLog(logFile)) {
+        m_error = m_layers.empty() ? "Archive belum dibuka" : m_layers.front()->GetError();
+        return false;
+    }
+    return true;
+}
+
+void ArchOverlay::Close() {
+    m_index.reset();
+    m_layers.clear();
+}
+
+bool ArchOverlay::FindEntry(const std::string& name, Location& location) const {
+    if (!m_index) {
+        return false;
+    }
+    const MergedIndex& index = GetIndex();
+
+    auto found = index.entries.find(std::string_view(name));
+    if (found == index.entries.end()) {
+        return false;
+    }
+    location = found->second;
+    return true;
+}
+
+uint64_t ArchOverlay::EstimateDecodeBytes(const Location& location) const {
+    const FileEntry& entry = *location.entry;
+    uint64_t bytes = static_cast<uint64_t>(entry.compressedSize) + entry.size;
+    if (entry.encryptionType == 1) {
+        // DecryptData menyimpan urutan pengacakan satu size_t per byte tersimpan
+        bytes += static_cast<uint64_t>(entry.compressedSize > 0 ? entry.compressedSize : entry.size) * sizeof(size_t);
+    }
+    if (!(entry.flags & FileEntry::FLAG_DELTA)) {
+        return bytes;
+    }
+    // Hasil delta dianggap seukuran base
+    Location base;
+    if (FindDeltaBase(location, base)) {
+        bytes += EstimateDecodeBytes(base) + base.entry->size;
+    }
+    return bytes;
+}
+
+std::vector<ArchOverlay::Location> ArchOverlay::GetEntries() const {
+    std::vector<Location> entries;
+    if (m_layers.size() == 1) {
+        // Satu layer tidak perlu digabung; cukup buang tombstone
+        const ArchReader& reader = *m_layers[0];
+        entries.reserve(reader.GetEntryCount());
+        for (uint32_t i = 0; i < reader.GetEntryCount(); ++i) {
+            if (!(reader.GetEntry(i).flags & FileEntry::FLAG_TOMBSTONE)) {
+                entries.push_back(Location{ 0, &reader.GetEntry(i) });
+            }
+        }
+    }
+    else if (m_index) {
+        const MergedIndex& index = GetIndex();
+        entries.reserve(index.entries.size());
+        for (const auto& item : index.entries) {
+            entries.push_back(item.second);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Location& a, const Location& b) {
+        return a.layer != b.layer ? a.layer < b.layer : a.entry->offset < b.entry->offset;
+    });
+    return entries;
+}
+
+EntryCache::Handle ArchOverlay::ReadEntryData(const Location& location, const std::vector<uint8_t>& key,
+    ArchScheduler* scheduler) const {
+    const ArchReader& reader = *m_layers[location.layer];
+    const FileEntry& entry = *location.entry;
+    EntryCache::Handle data = reader.ReadEntryData(entry, key, scheduler);
+    if (!data) {
+        throw std::runtime_error(reader.GetError());
+    }
+    if (!(entry.flags & FileEntry::FLAG_DELTA)) {
+        return data;
+    }
+
+    std::string name(entry.filename, strnlen(entry.filename, ArchConstants::MAX_FILENAME_LENGTH));
+    Location base;
+    if (!FindDeltaBase(location, base)) {
+        throw std::runtime_error("Base untuk entry delta tidak ditemukan: " + name);
+    }
+    EntryCache::Handle baseData = ReadEntryData(base, key, scheduler);
+    std::shared_ptr<std::vector<uint8_t>> target = std::make_shared<std::vector<uint8_t>>();
+    if (!ArchDelta::Apply(baseData->data(), baseData->size(), data->data(), data->size(), *target)) {
+        throw std::runtime_error("Delta tidak cocok dengan base di layer " +
+            std::to_string(base.layer) + " atau rusak: " + name);
+    }
+    return target;
+}
+
+bool ArchOverlay::FindDeltaBase(const Location& location, Location& base) const {
+    // Entry bernama sama terdekat di bawah layer delta. Tombstone di antaranya
+    // berarti base sudah dihapus, jadi pencarian berhenti di sana. Lookup tidak
+    // dicatat ke access log agar nama entry delta tidak tercatat dua kali.
+    const FileEntry& entry = *location.entry;
+    std::string name(entry.filename, strnlen(entry.filename, ArchConstants::MAX_FILENAME_LENGTH));
+    for (uint32_t layer = location.layer; layer-- > 0; ) {
+        const FileEntry* found = m_layers[layer]->PeekEntry(name);
+        if (!found) {
+            continue;
+        }
+        if (found->flags & FileEntry::FLAG_TOMBSTONE) {
+            return false;
+        }
+        base = Location{ layer, found };
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include "arch_reader.h"
+
+// Tumpukan archive read-only: base lalu patch-patch di atasnya. Nama dari
+// semua layer digabung ke satu index saat pertama kali dibutuhkan (layer
+// belakang menang, tombstone menghapus), sehingga lookup sama murahnya dengan
+// satu archive. Setelah Open, fungsi const aman dipanggil dari banyak thread.
+class ArchOverlay {
+public:
+    struct Location {
+        uint32_t layer;
+        const FileEntry* entry;
+    };
+
+    ArchOverlay();
+    ~ArchOverlay();
+
+    // layers[0] adalah base; layer berikutnya menimpa yang sebelumnya.
+    // volumeDirs diteruskan ke ArchReader::Open untuk archive multi-volume.
+    bool Open(const std::vector<std::string>& layers,
+        const std::vector<std::string>& volumeDirs = std::vector<std::string>());
+    void Close();
+
+    uint32_t GetLayerCount() const { return static_cast<uint32_t>(m_layers.size()); }
+    const ArchReader& GetLayer(uint32_t index) const { return *m_layers[index]; }
+    // false jika nama tidak ada atau sudah dihapus tombstone
+    bool FindEntry(const std::string& name, Location& location) const;
+    // Semua entry hasil gabungan tanpa tombstone, urut layer lalu offset blob
+    std::vector<Location> GetEntries() const;
+    // Isi entry hasil decode. Entry FLAG_DELTA diterapkan ke entry bernama sama
+    // di layer bawahnya (rantai delta diikuti sampai entry utuh). Melempar
+    // std::runtime_error jika entry atau base-nya gagal dibaca.
+    EntryCache::Handle ReadEntryData(const Location& location, const std::vector<uint8_t>& key,
+        ArchScheduler* scheduler = nullptr) const;
+    // Perkiraan puncak byte untuk men-decode entry: payload tersimpan dan
+    // hasilnya (plus tabel dekripsi), ditambah base dan hasil penerapan delta
+    // untuk entry FLAG_DELTA
+    uint64_t EstimateDecodeBytes(const Location& location) const;
+    const std::string& GetError() const { return m_error; }
+
+    // Akses semua layer dicatat ke satu log lewat layer base, karena layout
+    // profile hanya memakai path
+    bool EnableAccessLog(const std::string& logFile);
+    void LogAccess(const Location& location) const { m_layers.front()->LogAccess(*location.entry); }
+
+private:
+    struct MergedIndex {
+        std::once_flag built;
+        std::unordered_map<std::string_view, Location> entries;
+    };
+
+    const MergedIndex& GetIndex() const;
+    bool FindDeltaBase(const Location& location, Location& base) const;
+
+    std::vector<std::unique_ptr<ArchReader>> m_layers;
+    std::unique_ptr<MergedIndex> m_index;
+    std::string m_error;
+
+    ArchOverlay(const ArchOverlay&) = delete;
+    ArchOverlay& operator=(const ArchOverlay&) = delete;
+};
@@ -1,14 +1,41 @@
 ﻿#include "stdafx.h"
 #include "arch_packer.h"
+#include "arch_reader.h"
+#include "arch_overlay.h"
+#include "arch_delta.h"
+#include "arch_layout.h"
+#include "arch_scanner.h"
 #include <filesystem>
 #include <chrono>     
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <random>
 namespace fs = std::filesystem;
 
-ArchPacker::ArchPacker() {}
+ArchPacker::ArchPacker()
+    : m_useEncryption(false), m_streamingLayout(false), m_localHeaders(false), m_resume(false),
+    m_volumeCount(0), m_volumeSize(0), m_maxMemory(0), m_deltaFiles(0), m_unchangedFiles(0), m_alignment(1), m_writePos(0), m_paddingBytes(0) {}
 ArchPacker::~ArchPacker() {}
 bool ArchPacker::ReadHeader(std::ifstream& in, ArchHeader& header) {
     in.read(reinterpret_cast<char*>(&header), sizeof(header));
-    return in.good() && header.magic == ArchConstants::MAGIC;
+    if (!in.good() || header.magic != ArchConstants::MAGIC || header.version > ArchConstants::VERSION) {
+        return false;
+    }
+
+    if (header.flags & ArchHeader::FLAG_STREAMED) {
+        ArchFooter footer;
+        in.seekg(-static_cast<std::streamoff>(sizeof(footer)), std::ios::end);
+        in.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+        if (!in.good() || footer.magic != ArchConstants::FOOTER_MAGIC) {
+            return false;
+        }
+        header.fileCount = footer.fileCount;
+        header.indexOffset = footer.indexOffset;
+        header.indexChecksum = footer.indexChecksum;
+        in.seekg(sizeof(header));
+    }
+    return true;
 }
 
 bool ArchPacker::ReadFileEntries(std::ifstream& in, std::vector<FileEntry>& entries, uint32_t indexOffset) {
@@ -26,356 +53,1854 @@ bool ArchPacker::ReadFileEntries(std::ifstream& in, std::vector<FileEntry>& entr
 }
 
 
-void ArchPacker::SetEncryptionKey(const std::string& passphrase) {
+void ArchPacker::SetEncryptionKey(const std::string& passphrase, bool encryptAll) {
     m_encryptionKey = ArchCrypto::GenerateKey(passphrase);
-    m_useEncryption = !passphrase.empty();
+    m_useEncryption = encryptAll && !passphrase.empty();
 }
 
 bool ArchPacker::CreateArchive(const std::string& outputFile,
     const std::vector<std::string>& inputPaths,
     bool enableCompression) {
+    if (outputFile == "-") {
+        return CreateArchive(std::cout, inputPaths, enableCompression);
+    }
+
+    m_failures.clear();
+    std::vector<ManifestEntry> manifest;
+    try {
+        manifest = BuildManifest(inputPaths);
+    }
+    catch (const std::exception& e) {
+        m_error = e.what();
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+    return CreateArchive(outputFile, manifest, enableCompression);
+}
+
+bool ArchPacker::CreateArchive(const std::string& outputFile,
+    const std::vector<ManifestEntry>& manifest,
+    bool enableCompression) {
+    const std::string partFile = outputFile + ".part";
+    const std::string journalFile = outputFile + ".journal";
+    bool journaled = false;
+    m_failures.clear();
     try {
-        std::ofstream out(outputFile, std::ios::binary);
-        if (!out) {
-            throw std::runtime_error("Cannot create output file: " + outputFile);
+        if (m_volumeCount > 1 || m_volumeSize > 0) {
+            WriteVolumes(outputFile, manifest, enableCompression);
+            return true;
         }
 
-        uint32_t totalFiles = 0;
-        for (const auto& path : inputPaths) {
-            if (fs::is_directory(path)) {
-                for (const auto& entry : fs::recursive_directory_iterator(path)) {
-                    if (entry.is_regular_file()) totalFiles++;
+        ArchJournal journal;
+
+        // Tanpa kompresi dan enkripsi ukuran setiap blob sudah diketahui dari
+        // manifest, jadi semua offset bisa dihitung di depan dan file disalin paralel.
+        // Delta baru diketahui ukurannya setelah di-encode, jadi lewat jalur biasa.
+        // Jalur ini hanya menyalin, jadi diulang dari awal tanpa journal.
+        if (!enableCompression && !m_useEncryption && m_deltaBases.empty() && !m_policy.AffectsPayload()) {
+            WriteStoredArchive(partFile, manifest, m_streamingLayout);
+        }
+        else {
+            ArchJournal::State progress;
+            journal.Open(journalFile, partFile,
+                Fingerprint(manifest, enableCompression), m_resume, progress);
+            journaled = true;
+
+            std::fstream out;
+            if (progress.writePos > 0) {
+                std::error_code ec;
+                uint64_t partSize = fs::file_size(partFile, ec);
+                if (ec || partSize < progress.writePos) {
+                    throw std::runtime_error("File " + partFile +
+                        " lebih pendek dari checkpoint journal, tidak bisa dilanjutkan");
                 }
+                // Data setelah checkpoint terakhir belum tercatat dan ditulis ulang
+                fs::resize_file(partFile, progress.writePos);
+                out.open(partFile, std::ios::in | std::ios::out | std::ios::binary);
+                out.seekp(static_cast<std::streamoff>(progress.writePos));
+                std::clog << "Melanjutkan dari checkpoint: " << progress.itemsDone << "/"
+                    << manifest.size() << " file sudah selesai\n";
             }
             else {
-                totalFiles++;
+                out.open(partFile, std::ios::out | std::ios::binary | std::ios::trunc);
             }
-        }
-
-        WriteHeader(out, totalFiles, 0);
-
-        std::vector<FileEntry> entries;
-        for (const auto& path : inputPaths) {
-            if (fs::is_directory(path)) {
-                ProcessFolder(path, out, entries, enableCompression);
+            if (!out) {
+                throw std::runtime_error("Cannot create output file: " + partFile);
             }
-            else {
-                ProcessFile(path, out, entries, enableCompression);
+
+            WriteArchive(out, manifest, enableCompression, m_streamingLayout, &journal, &progress);
+            out.close();
+            if (out.fail()) {
+                throw std::runtime_error("Gagal menulis archive");
             }
         }
 
-        uint32_t indexOffset = static_cast<uint32_t>(out.tellp());
-
-        for (const auto& entry : entries) {
-            out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        // Output lama (jika ada) baru diganti setelah archive baru lengkap
+        if (!MoveFileExA(partFile.c_str(), outputFile.c_str(),
+            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            throw std::runtime_error("Gagal mengganti nama " + partFile + " ke " + outputFile +
+                ": " + ArchUtils::GetLastErrorString());
+        }
+        if (journaled) {
+            journal.Remove();
+        }
+        else {
+            // Journal dari percobaan dengan opsi lain menunjuk ke .part yang sudah ditimpa
+            DeleteFileA(journalFile.c_str());
         }
-
-        out.seekp(0);
-        WriteHeader(out, static_cast<uint32_t>(entries.size()), indexOffset);
-
         return true;
     }
     catch (const std::exception& e) {
+        m_error = e.what();
         std::cerr << "Error: " << e.what() << std::endl;
+        if (journaled) {
+            std::cerr << "Archive belum lengkap; jalankan lagi dengan --resume untuk melanjutkan" << std::endl;
+        }
+        else {
+            DeleteFileA(partFile.c_str());
+        }
         return false;
     }
 }
 
-void ArchPacker::WriteHeader(std::ofstream& out, uint32_t fileCount, uint32_t indexOffset) {
-    ArchHeader header;
-    header.fileCount = fileCount;
-    header.indexOffset = indexOffset;
-    header.flags = 0;
-    memset(header.reserved, 0, sizeof(header.reserved));
-
-    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
-}
-
-void ArchPacker::ProcessFile(const std::string& filePath,
-    std::ofstream& out,
-    std::vector<FileEntry>& entries,
+bool ArchPacker::CreateArchive(std::ostream& out,
+    const std::vector<std::string>& inputPaths,
     bool enableCompression) {
-    FileEntry entry;
-    memset(&entry, 0, sizeof(entry));
-
-    fs::path path(filePath);
-    std::string filename = path.filename().string();
+    m_failures.clear();
+    try {
+        WriteArchive(out, BuildManifest(inputPaths), enableCompression, true);
+        return true;
+    }
+    catch (const std::exception& e) {
+        m_error = e.what();
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+}
 
-    if (filename.length() >= ArchConstants::MAX_FILENAME_LENGTH) {
-        throw std::runtime_error("Filename exceeds maximum length");
+std::vector<ManifestEntry> ArchPacker::BuildManifest(const std::vector<std::string>& inputPaths) {
+    std::vector<ManifestEntry> manifest;
+    for (const auto& path : inputPaths) {
+        if (fs::is_directory(path)) {
+            CollectFolder(path, manifest);
+        }
+        else {
+            CollectFile(path, manifest);
+        }
     }
 
+    if (!m_layoutProfile.empty()) {
+        size_t profiled = ArchLayout::ApplyProfile(m_layoutProfile, manifest);
+        std::clog << "Layout profile: " << profiled << " dari " << manifest.size()
+            << " file diurutkan menurut access log\n";
+    }
 
-    strncpy_s(entry.filename, filename.c_str(), ArchConstants::MAX_FILENAME_LENGTH - 1);
-    entry.filename[ArchConstants::MAX_FILENAME_LENGTH - 1] = '\0';
+    for (const auto& path : m_deletions) {
+        if (path.empty() || path.length() >= ArchConstants::MAX_FILENAME_LENGTH) {
+            throw std::runtime_error("Path tombstone tidak valid: " + path);
+        }
+        ManifestEntry item;
+        item.archivePath = path;
+        item.tombstone = true;
+        manifest.push_back(std::move(item));
+    }
+    return manifest;
+}
 
-    std::ifstream in(filePath, std::ios::binary | std::ios::ate);
-    if (!in) {
-        throw std::runtime_error("Cannot open input file: " + filePath);
+void ArchPacker::WriteArchive(std::ostream& out,
+    const std::vector<ManifestEntry>& manifest,
+    bool enableCompression,
+    bool streamed,
+    ArchJournal* journal,
+    ArchJournal::State* progress) {
+    ArchJournal::State fresh;
+    ArchJournal::State& state = progress ? *progress : fresh;
+    m_writePos = state.writePos;
+    m_paddingBytes = state.paddingBytes;
+    m_deltaFiles = state.deltaFiles;
+    m_unchangedFiles = state.unchangedFiles;
+
+    std::unique_ptr<ArchOverlay> deltaBase = OpenDeltaBase();
+
+    // Layout streaming tidak pernah kembali ke header, jadi jumlah file dan
+    // offset index hanya ditulis di footer setelah index
+    uint32_t flags = ArchHeader::FLAG_CHECKSUMS;
+    if (streamed) flags |= ArchHeader::FLAG_STREAMED;
+    if (m_localHeaders) flags |= ArchHeader::FLAG_LOCAL_HEADERS;
+    if (state.itemsDone == 0) {
+        WriteHeader(out, streamed ? 0 : static_cast<uint32_t>(manifest.size()), 0, flags);
     }
 
-    entry.size = static_cast<uint32_t>(in.tellg());
-    entry.offset = static_cast<uint32_t>(out.tellp());
+    std::vector<FileEntry>& entries = state.entries;
+    entries.reserve(manifest.size());
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+    uint64_t checkpointPos = m_writePos;
+    PackInOrder(manifest, state.itemsDone, enableCompression, deltaBase.get(),
+        [&](size_t i, PreparedEntry& prepared) {
+        try {
+            WritePrepared(prepared, out, entries);
+        }
+        catch (const std::exception& e) {
+            if (!out) throw;
+            m_failures.push_back(manifest[i].sourcePath + ": " + e.what());
+        }
 
-    auto ftime = fs::last_write_time(filePath);
-    auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-        ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
-    entry.timestamp = std::chrono::system_clock::to_time_t(sctp);
+        if (journal) {
+            auto now = std::chrono::steady_clock::now();
+            if (m_writePos - checkpointPos >= ArchJournal::CHECKPOINT_BYTES ||
+                now - lastCheckpoint >= std::chrono::seconds(ArchJournal::CHECKPOINT_SECONDS)) {
+                if (!out.flush()) {
+                    throw std::runtime_error("Gagal menulis archive");
+                }
+                state.itemsDone = static_cast<uint32_t>(i + 1);
+                state.writePos = m_writePos;
+                state.paddingBytes = m_paddingBytes;
+                state.deltaFiles = m_deltaFiles;
+                state.unchangedFiles = m_unchangedFiles;
+                journal->Checkpoint(state);
+                lastCheckpoint = now;
+                checkpointPos = m_writePos;
+            }
+        }
+    });
 
-    entry.checksum = ArchUtils::CalculateChecksum(filePath);
+    if (m_localHeaders) {
+        uint32_t endMagic = ArchConstants::LOCAL_END_MAGIC;
+        WriteData(out, &endMagic, sizeof(endMagic));
+    }
+    if (deltaBase) {
+        std::clog << "Delta: " << m_deltaFiles << " file sebagai delta, "
+            << m_unchangedFiles << " file sama dengan base tidak ditulis\n";
+    }
 
-    in.seekg(0);
-    std::vector<uint8_t> buffer(entry.size);
-    in.read(reinterpret_cast<char*>(buffer.data()), entry.size);
+    uint32_t indexOffset = CurrentOffset();
+    uint32_t indexChecksum = crc32(0, reinterpret_cast<const Bytef*>(entries.data()),
+        static_cast<uInt>(entries.size() * sizeof(FileEntry)));
 
-    if (enableCompression) {
-        std::vector<uint8_t> compressedData;
-        ArchUtils::CompressData(buffer, compressedData);
+    for (const auto& entry : entries) {
+        WriteData(out, &entry, sizeof(entry));
+    }
 
-        if (compressedData.size() < buffer.size()) {
-            out.write(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
-            entry.compressionType = 1;
-            entry.compressedSize = static_cast<uint32_t>(compressedData.size());
-        }
-        else {
-            out.write(reinterpret_cast<char*>(buffer.data()), buffer.size());
-            entry.compressionType = 0;
-            entry.compressedSize = 0;
-        }
+    if (streamed) {
+        ArchFooter footer;
+        footer.fileCount = static_cast<uint32_t>(entries.size());
+        footer.indexOffset = indexOffset;
+        footer.indexChecksum = indexChecksum;
+        WriteData(out, &footer, sizeof(footer));
+        out.flush();
     }
     else {
-        out.write(reinterpret_cast<char*>(buffer.data()), buffer.size());
-        entry.compressionType = 0;
-        entry.compressedSize = 0;
+        out.seekp(0);
+        WriteHeader(out, static_cast<uint32_t>(entries.size()), indexOffset, flags, indexChecksum);
     }
 
-    if (m_useEncryption) {
-        ArchCrypto::EncryptData(buffer, m_encryptionKey);
-        entry.encryptionType = 1;
+    if (!out) {
+        throw std::runtime_error("Gagal menulis archive");
+    }
+}
 
+std::unique_ptr<ArchOverlay> ArchPacker::OpenDeltaBase() const {
+    std::unique_ptr<ArchOverlay> deltaBase;
+    if (!m_deltaBases.empty()) {
+        deltaBase.reset(new ArchOverlay());
+        if (!deltaBase->Open(m_deltaBases, m_volumeDirs)) {
+            throw std::runtime_error("Gagal membuka archive base: " + deltaBase->GetError());
+        }
     }
-    else {
-        entry.encryptionType = 0;
+    return deltaBase;
+}
+
+void ArchPacker::WriteVolumes(const std::string& outputFile,
+    const std::vector<ManifestEntry>& manifest,
+    bool enableCompression) {
+    if (m_streamingLayout || m_localHeaders) {
+        throw std::runtime_error("Archive multi-volume tidak mendukung --stream atau --local-headers");
+    }
+    if (m_resume) {
+        // Journal hanya mencatat satu file .part; volume selalu ditulis ulang dari awal
+        throw std::runtime_error("Archive multi-volume tidak mendukung --resume");
     }
 
-    entries.push_back(entry);
+    struct Volume {
+        std::string path;
+        std::ofstream out;
+        uint64_t position = 0;
+        uint32_t blobs = 0;
+        bool renamed = false;
+    };
+    std::vector<std::unique_ptr<Volume>> volumes;
+    const uint32_t flags = ArchHeader::FLAG_CHECKSUMS | ArchHeader::FLAG_VOLUMES;
+    const uint32_t volumeSetId = std::random_device()();
+
+    // Setiap volume ditulis ke .part dan baru di-rename setelah semuanya lengkap.
+    // Jika rename gagal di tengah, volume yang sudah bernama akhir ikut dihapus
+    // agar tidak tertinggal set volume campuran
+    auto removeParts = [&]() {
+        for (auto& volume : volumes) {
+            volume->out.close();
+            DeleteFileA((volume->renamed ? volume->path : volume->path + ".part").c_str());
+        }
+    };
+    auto addVolume = [&]() {
+        uint32_t index = static_cast<uint32_t>(volumes.size());
+        if (index >= FileEntry::MAX_VOLUMES) {
+            throw std::runtime_error("Jumlah volume melebihi batas " + std::to_string(FileEntry::MAX_VOLUMES));
+        }
+        std::unique_ptr<Volume> volume(new Volume());
+        volume->path = outputFile;
+        if (index > 0) {
+            volume->path = ArchUtils::VolumePath(outputFile, index);
+            if (!m_volumeDirs.empty()) {
+                volume->path = (fs::path(m_volumeDirs[(index - 1) % m_volumeDirs.size()]) /
+                    fs::path(volume->path).filename()).string();
+            }
+        }
+        volume->out.open(volume->path + ".part", std::ios::binary | std::ios::trunc);
+        if (!volume->out) {
+            throw std::runtime_error("Cannot create output file: " + volume->path + ".part");
+        }
 
+        m_writePos = 0;
+        if (index == 0) {
+            WriteHeader(volume->out, static_cast<uint32_t>(manifest.size()), 0, flags, 0, 0, volumeSetId);
+        }
+        else {
+            VolumeHeader header = { ArchConstants::VOLUME_MAGIC, volumeSetId, index, 0 };
+            WriteData(volume->out, &header, sizeof(header));
+        }
+        volume->position = m_writePos;
+        volumes.push_back(std::move(volume));
+    };
 
-}
-void ArchPacker::ProcessFolder(const std::string& folderPath,
-    std::ofstream& out,
-    std::vector<FileEntry>& entries,
-    bool enableCompression,
-    const std::string& relativePath) {
     try {
-        for (const auto& entry : fs::directory_iterator(folderPath)) {
-            if (entry.is_directory()) {
-                std::string newRelativePath = relativePath + entry.path().filename().string() + "/";
-                ProcessFolder(entry.path().string(), out, entries, enableCompression, newRelativePath);
+        m_paddingBytes = 0;
+        m_deltaFiles = 0;
+        m_unchangedFiles = 0;
+        std::unique_ptr<ArchOverlay> deltaBase = OpenDeltaBase();
+
+        uint32_t initialVolumes = m_volumeSize > 0 ? 1 : std::min(m_volumeCount, FileEntry::MAX_VOLUMES);
+        for (uint32_t i = 0; i < initialVolumes; ++i) {
+            addVolume();
+        }
+
+        std::vector<FileEntry> entries;
+        entries.reserve(manifest.size());
+        PackInOrder(manifest, 0, enableCompression, deltaBase.get(),
+            [&](size_t i, PreparedEntry& prepared) {
+            const ManifestEntry& item = manifest[i];
+            // Mode ukuran mengisi volume satu per satu; mode jumlah memilih
+            // volume yang paling sedikit terisi agar byte tersebar rata
+            uint32_t target = 0;
+            if (m_volumeSize > 0) {
+                const Volume& active = *volumes.back();
+                if (active.blobs > 0 && active.position + item.size > m_volumeSize) {
+                    addVolume();
+                }
+                target = static_cast<uint32_t>(volumes.size() - 1);
             }
-            else if (entry.is_regular_file()) {
-                try {
-                    std::string fullPath = entry.path().string();
-                    std::string archivePath = relativePath + entry.path().filename().string();
+            else {
+                for (uint32_t i = 1; i < volumes.size(); ++i) {
+                    if (volumes[i]->position < volumes[target]->position) {
+                        target = i;
+                    }
+                }
+            }
+
+            Volume& volume = *volumes[target];
+            size_t before = entries.size();
+            m_writePos = volume.position;
+            try {
+                WritePrepared(prepared, volume.out, entries);
+            }
+            catch (const std::exception& e) {
+                if (!volume.out) throw;
+                m_failures.push_back(item.sourcePath + ": " + e.what());
+            }
+            volume.position = m_writePos;
+            if (entries.size() > before) {
+                entries.back().flags |= target << FileEntry::VOLUME_SHIFT;
+                volume.blobs++;
+            }
+        });
+        if (deltaBase) {
+            std::clog << "Delta: " << m_deltaFiles << " file sebagai delta, "
+                << m_unchangedFiles << " file sama dengan base tidak ditulis\n";
+        }
 
-                    FileEntry fileEntry;
-                    memset(&fileEntry, 0, sizeof(fileEntry));
+        Volume& first = *volumes[0];
+        m_writePos = first.position;
+        uint32_t indexOffset = CurrentOffset();
+        uint32_t indexChecksum = crc32(0, reinterpret_cast<const Bytef*>(entries.data()),
+            static_cast<uInt>(entries.size() * sizeof(FileEntry)));
+        for (const auto& entry : entries) {
+            WriteData(first.out, &entry, sizeof(entry));
+        }
+        first.out.seekp(0);
+        WriteHeader(first.out, static_cast<uint32_t>(entries.size()), indexOffset, flags, indexChecksum,
+            static_cast<uint32_t>(volumes.size()), volumeSetId);
+
+        for (auto& volume : volumes) {
+            volume->out.close();
+            if (volume->out.fail()) {
+                throw std::runtime_error("Gagal menulis volume " + volume->path);
+            }
+        }
+        // File utama terakhir: selama belum ada, volume lain tidak terbaca sebagai archive
+        for (size_t i = volumes.size(); i-- > 0; ) {
+            const std::string& path = volumes[i]->path;
+            if (!MoveFileExA((path + ".part").c_str(), path.c_str(),
+                MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+                throw std::runtime_error("Gagal mengganti nama " + path + ".part: " +
+                    ArchUtils::GetLastErrorString());
+            }
+            volumes[i]->renamed = true;
+        }
+        std::clog << "Volume: " << volumes.size() << " file\n";
+    }
+    catch (...) {
+        removeParts();
+        throw;
+    }
+}
 
-                    if (archivePath.length() >= ArchConstants::MAX_FILENAME_LENGTH) {
-                        std::cerr << "Warning: Path terlalu panjang, file akan dilewati: "
-                            << fullPath << std::endl;
-                        continue;
-                    }
-                    strncpy_s(fileEntry.filename, archivePath.c_str(), ArchConstants::MAX_FILENAME_LENGTH - 1);
+void ArchPacker::WriteStoredArchive(const std::string& outputFile,
+    const std::vector<ManifestEntry>& manifest,
+    bool streamed) {
+    m_paddingBytes = 0;
 
-                    std::ifstream in(fullPath, std::ios::binary | std::ios::ate);
-                    if (!in) {
-                        std::cerr << "Warning: Tidak bisa membuka file: " << fullPath << std::endl;
-                        continue;
-                    }
+    struct StoredJob {
+        const ManifestEntry* item;
+        FileEntry entry;
+        uint64_t localOffset;
+    };
+
+    // Tahap 1: tentukan offset setiap blob (termasuk local header dan padding)
+    std::vector<StoredJob> jobs;
+    jobs.reserve(manifest.size());
+    uint64_t position = sizeof(ArchHeader);
+    const uint64_t localSize = m_localHeaders ? sizeof(LocalEntryHeader) : 0;
+    const uint32_t blockSize = ArchConstants::CHECK_BLOCK_SIZE;
+
+    for (const auto& item : manifest) {
+        StoredJob job;
+        job.item = &item;
+        memset(&job.entry, 0, sizeof(job.entry));
+        strncpy_s(job.entry.filename, item.archivePath.c_str(), ArchConstants::MAX_FILENAME_LENGTH - 1);
+
+        if (item.size > UINT32_MAX) {
+            m_failures.push_back(item.sourcePath + ": File melebihi batas 4 GB format archive");
+            continue;
+        }
+        job.entry.size = static_cast<uint32_t>(item.size);
+        job.entry.timestamp = item.timestamp;
+        job.entry.flags = item.tombstone ? FileEntry::FLAG_TOMBSTONE : FileEntry::FLAG_BLOCK_CHECKSUMS;
+
+        uint32_t alignment = item.tombstone ? 1 : GetAlignment(job.entry.filename);
+        uint64_t blobStart = position + localSize;
+        uint64_t padding = (alignment - blobStart % alignment) % alignment;
+        if (blobStart + padding > UINT32_MAX) {
+            throw std::runtime_error("Archive melebihi batas offset 32-bit (4 GB)");
+        }
 
-                    fileEntry.size = static_cast<uint32_t>(in.tellg());
-                    fileEntry.offset = static_cast<uint32_t>(out.tellp());
+        job.localOffset = position;
+        job.entry.offset = static_cast<uint32_t>(blobStart + padding);
+        m_paddingBytes += padding;
+        position = job.entry.offset + static_cast<uint64_t>(job.entry.size) +
+            ArchUtils::BlockCount(job.entry.size, blockSize) * sizeof(uint32_t);
+        jobs.push_back(job);
+    }
 
-                    auto ftime = fs::last_write_time(entry);
-                    auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-                        ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
-                    fileEntry.timestamp = std::chrono::system_clock::to_time_t(sctp);
+    uint64_t endMagicOffset = position;
+    if (m_localHeaders) {
+        position += sizeof(uint32_t);
+    }
+    if (position > UINT32_MAX) {
+        throw std::runtime_error("Archive melebihi batas offset 32-bit (4 GB)");
+    }
+    uint32_t indexOffset = static_cast<uint32_t>(position);
+    uint64_t totalSize = position + jobs.size() * sizeof(FileEntry) + (streamed ? sizeof(ArchFooter) : 0);
+
+    // Tahap 2: alokasikan file output sekaligus, lalu salin data secara paralel
+    // ke offset masing-masing dengan write posisional
+    HANDLE out = CreateFileA(outputFile.c_str(), GENERIC_WRITE, 0, NULL,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, NULL);
+    if (out == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot create output file: " + outputFile);
+    }
 
-                    fileEntry.checksum = ArchUtils::CalculateChecksum(fullPath);
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(totalSize);
+    if (!SetFilePointerEx(out, end, NULL, FILE_BEGIN) || !SetEndOfFile(out)) {
+        CloseHandle(out);
+        throw std::runtime_error("Gagal mengalokasikan file output: " + ArchUtils::GetLastErrorString());
+    }
 
-                    in.seekg(0);
-                    std::vector<uint8_t> buffer(fileEntry.size);
-                    in.read(reinterpret_cast<char*>(buffer.data()), fileEntry.size);
+    std::atomic<size_t> nextJob(0);
+    std::atomic<bool> failed(false);
+    std::mutex errorLock;
+    std::string firstError;
 
-                    if (enableCompression) {
-                        std::vector<uint8_t> compressedData;
-                        ArchUtils::CompressData(buffer, compressedData);
+    auto worker = [&]() {
+        std::vector<uint8_t> buffer(1 << 20);
+        size_t index;
+        while (!failed && (index = nextJob++) < jobs.size()) {
+            StoredJob& job = jobs[index];
+            try {
+                if (job.item->tombstone) {
+                    LocalEntryHeader local;
+                    local.entry = job.entry;
+                    if (m_localHeaders && !ArchUtils::WriteAt(out, job.localOffset, &local, sizeof(local))) {
+                        throw std::runtime_error("Gagal menulis archive: " + ArchUtils::GetLastErrorString());
+                    }
+                    continue;
+                }
 
-                        if (compressedData.size() < buffer.size()) {
-                            if (m_useEncryption) {
-                                ArchCrypto::EncryptData(compressedData, m_encryptionKey); 
-                            }
-                            out.write(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
-                            fileEntry.compressionType = 1;
-                            fileEntry.compressedSize = static_cast<uint32_t>(compressedData.size());
-                        }
-                        else {
-                            if (m_useEncryption) {
-                                ArchCrypto::EncryptData(buffer, m_encryptionKey); 
-                            }
-                            out.write(reinterpret_cast<char*>(buffer.data()), buffer.size());
-                            fileEntry.compressionType = 0;
-                            fileEntry.compressedSize = 0;
-                        }
+                if (job.item->data) {
+                    const std::vector<uint8_t>& data = *job.item->data;
+                    std::vector<uint32_t> blocks;
+                    ArchUtils::UpdateBlockChecksums(blocks, 0, data.data(), data.size(), blockSize);
+                    job.entry.checksum = ArchUtils::UpdateChecksum(0, data.data(), data.size());
+                    bool written = ArchUtils::WriteAt(out, job.entry.offset, data.data(), data.size()) &&
+                        (blocks.empty() || ArchUtils::WriteAt(out, job.entry.offset + data.size(),
+                            blocks.data(), blocks.size() * sizeof(uint32_t)));
+                    if (m_localHeaders) {
+                        LocalEntryHeader local;
+                        local.entry = job.entry;
+                        written = written && ArchUtils::WriteAt(out, job.localOffset, &local, sizeof(local));
                     }
-                    else {
-                        if (m_useEncryption) {
-                            ArchCrypto::EncryptData(buffer, m_encryptionKey); 
-                        }
-                        out.write(reinterpret_cast<char*>(buffer.data()), buffer.size());
-                        fileEntry.compressionType = 0;
-                        fileEntry.compressedSize = 0;
+                    if (!written) {
+                        throw std::runtime_error("Gagal menulis archive: " + ArchUtils::GetLastErrorString());
                     }
+                    continue;
+                }
 
-                    fileEntry.encryptionType = m_useEncryption ? 1 : 0;
-                    entries.push_back(fileEntry);
+                HANDLE in = CreateFileA(job.item->sourcePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+                if (in == INVALID_HANDLE_VALUE) {
+                    throw std::runtime_error("Tidak bisa membuka file");
                 }
-                catch (const std::exception& e) {
-                    std::cerr << "Error memproses file " << entry.path().string()
-                        << ": " << e.what() << std::endl;
+
+                uint64_t copied = 0;
+                uint32_t checksum = 0;
+                std::vector<uint32_t> blocks;
+                bool ok = true;
+                while (ok) {
+                    size_t got = 0;
+                    ArchUtils::ReadAt(in, copied, buffer.data(), buffer.size(), &got);
+                    if (got == 0) break;
+                    if (copied + got > job.entry.size) {
+                        ok = false;
+                        break;
+                    }
+                    checksum = ArchUtils::UpdateChecksum(checksum, buffer.data(), got);
+                    ArchUtils::UpdateBlockChecksums(blocks, copied, buffer.data(), got, blockSize);
+                    if (!ArchUtils::WriteAt(out, job.entry.offset + copied, buffer.data(), got)) {
+                        CloseHandle(in);
+                        throw std::runtime_error("Gagal menulis archive: " + ArchUtils::GetLastErrorString());
+                    }
+                    copied += got;
+                }
+                CloseHandle(in);
+
+                if (!ok || copied != job.entry.size) {
+                    throw std::runtime_error("Ukuran file berubah selama proses pack");
+                }
+                job.entry.checksum = checksum;
+
+                if (!blocks.empty() && !ArchUtils::WriteAt(out, job.entry.offset + copied,
+                    blocks.data(), blocks.size() * sizeof(uint32_t))) {
+                    throw std::runtime_error("Gagal menulis archive: " + ArchUtils::GetLastErrorString());
+                }
+
+                if (m_localHeaders) {
+                    LocalEntryHeader local;
+                    local.entry = job.entry;
+                    if (!ArchUtils::WriteAt(out, job.localOffset, &local, sizeof(local))) {
+                        throw std::runtime_error("Gagal menulis archive: " + ArchUtils::GetLastErrorString());
+                    }
+                }
+            }
+            catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(errorLock);
+                if (!failed) {
+                    firstError = job.item->sourcePath + ": " + e.what();
+                    failed = true;
                 }
             }
         }
+    };
+
+    // Penyalinan dibatasi I/O, bukan CPU; beberapa thread sudah cukup untuk
+    // menjaga antrean disk tetap penuh
+    unsigned threadCount = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(jobs.size(), 1)));
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back(worker);
     }
-    catch (const std::exception& e) {
-        throw std::runtime_error("Error memproses folder " + folderPath + ": " + e.what());
+    for (auto& thread : threads) {
+        thread.join();
     }
-}
-bool ArchPacker::ExtractArchive(const std::string& inputFile,
-    const std::string& outputDir,
-    bool preserveStructure)
-{
-    try {
-        std::ifstream in(inputFile, std::ios::binary);
-        if (!in) {
-            throw std::runtime_error("Gagal membuka file archive: " + inputFile);
-        }
 
-        ArchHeader header;
-        if (!ReadHeader(in, header)) {
-            throw std::runtime_error("Format archive tidak valid atau corrupt");
-        }
+    if (failed) {
+        CloseHandle(out);
+        throw std::runtime_error("Error memproses file " + firstError);
+    }
 
-        std::vector<FileEntry> entries;
-        if (!ReadFileEntries(in, entries, header.indexOffset)) {
-            throw std::runtime_error("Gagal membaca tabel file entries");
-        }
+    // Tahap 3: penanda akhir, index, header dan footer
+    std::vector<FileEntry> entries;
+    entries.reserve(jobs.size());
+    for (const auto& job : jobs) {
+        entries.push_back(job.entry);
+    }
 
+    uint32_t indexChecksum = crc32(0, reinterpret_cast<const Bytef*>(entries.data()),
+        static_cast<uInt>(entries.size() * sizeof(FileEntry)));
 
-        fs::path outputPath = outputDir.empty() ? fs::path(inputFile).stem() : outputDir;
-        if (!fs::exists(outputPath)) {
-            fs::create_directories(outputPath);
-        }
+    ArchHeader header;
+    header.flags = ArchHeader::FLAG_CHECKSUMS |
+        (streamed ? ArchHeader::FLAG_STREAMED : 0) |
+        (m_localHeaders ? ArchHeader::FLAG_LOCAL_HEADERS : 0);
+    header.blockSize = blockSize;
+    if (!streamed) {
+        header.fileCount = static_cast<uint32_t>(entries.size());
+        header.indexOffset = indexOffset;
+        header.indexChecksum = indexChecksum;
+    }
+    header.headerChecksum = header.ComputeChecksum();
 
-        int totalFiles = static_cast<int>(entries.size());
-        int successCount = 0;
-        int encryptedFiles = 0;
-        bool hasEncryptionErrors = false;
+    bool ok = ArchUtils::WriteAt(out, 0, &header, sizeof(header));
+    if (m_localHeaders) {
+        uint32_t endMagic = ArchConstants::LOCAL_END_MAGIC;
+        ok = ok && ArchUtils::WriteAt(out, endMagicOffset, &endMagic, sizeof(endMagic));
+    }
+    ok = ok && (entries.empty() ||
+        ArchUtils::WriteAt(out, indexOffset, entries.data(), entries.size() * sizeof(FileEntry)));
+    if (streamed) {
+        ArchFooter footer;
+        footer.fileCount = static_cast<uint32_t>(entries.size());
+        footer.indexOffset = indexOffset;
+        footer.indexChecksum = indexChecksum;
+        ok = ok && ArchUtils::WriteAt(out, indexOffset + entries.size() * sizeof(FileEntry),
+            &footer, sizeof(footer));
+    }
+    CloseHandle(out);
 
-        std::cout << "Memulai ekstraksi " << totalFiles << " file ke: "
-            << outputPath.string() << "\n";
+    if (!ok) {
+        throw std::runtime_error("Gagal menulis archive: " + ArchUtils::GetLastErrorString());
+    }
+}
 
+void ArchPacker::WriteHeader(std::ostream& out, uint32_t fileCount, uint32_t indexOffset,
+    uint32_t flags, uint32_t indexChecksum, uint32_t volumeCount, uint32_t volumeSetId) {
+    ArchHeader header;
+    header.fileCount = fileCount;
+    header.indexOffset = indexOffset;
+    header.flags = flags;
+    header.volumeCount = volumeCount;
+    header.volumeSetId = volumeSetId;
+    if (flags & ArchHeader::FLAG_CHECKSUMS) {
+        header.blockSize = ArchConstants::CHECK_BLOCK_SIZE;
+        header.indexChecksum = indexChecksum;
+    }
+    header.headerChecksum = header.ComputeChecksum();
 
-        for (const auto& entry : entries) {
-            try {
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_writePos += sizeof(header);
+}
 
+void ArchPacker::WriteData(std::ostream& out, const void* data, size_t size) {
+    if (!out.write(static_cast<const char*>(data), size)) {
+        throw std::runtime_error("Gagal menulis archive");
+    }
+    m_writePos += size;
+}
 
-                std::cout << "  [" << (successCount + 1) << "/" << totalFiles << "] "
-                    << entry.filename;
+uint32_t ArchPacker::CurrentOffset() const {
+    if (m_writePos > UINT32_MAX) {
+        throw std::runtime_error("Archive melebihi batas offset 32-bit (4 GB)");
+    }
+    return static_cast<uint32_t>(m_writePos);
+}
 
-                if (entry.encryptionType == 1) {
-                    std::cout << " [ENCRYPTED]";
-                    encryptedFiles++;
-                }
-                if (entry.compressionType == 1) {
-                    std::cout << " [COMPRESSED]";
-                }
-                std::cout << "\n";
+void ArchPacker::CollectFile(const std::string& filePath,
+    std::vector<ManifestEntry>& manifest) {
+    ManifestEntry item;
+    item.sourcePath = filePath;
+    item.archivePath = fs::path(filePath).filename().string();
 
-                fs::path filePath = outputPath;
-                if (preserveStructure) {
-                    filePath /= entry.filename;
-                    fs::create_directories(filePath.parent_path());
-                }
-                else {
-                    filePath /= fs::path(entry.filename).filename();
-                }
+    if (item.archivePath.length() >= ArchConstants::MAX_FILENAME_LENGTH) {
+        throw std::runtime_error("Filename exceeds maximum length");
+    }
+    if (!ArchScanner::StatFile(filePath, item)) {
+        throw std::runtime_error("Cannot open input file: " + filePath);
+    }
 
-                in.seekg(entry.offset);
-                std::vector<uint8_t> fileData(entry.compressedSize > 0 ?
-                    entry.compressedSize : entry.size);
-                in.read(reinterpret_cast<char*>(fileData.data()), fileData.size());
+    manifest.push_back(std::move(item));
+}
 
-                std::vector<uint8_t> processedData;
-                if (entry.encryptionType == 1) {
-                    if (m_encryptionKey.empty()) {
-                        throw std::runtime_error("File terenkripsi tetapi passphrase tidak diberikan");
-                    }
-                    ArchCrypto::DecryptData(fileData, m_encryptionKey); // Dekripsi sebelum dekompresi
-                }
-                if (entry.compressionType == 1) {
-                    std::vector<char> compressedData(fileData.begin(), fileData.end());
-                    std::vector<char> decompressedData;
-                    if (!ArchUtils::DecompressData(compressedData, decompressedData, entry.size)) {
-                        throw std::runtime_error("Dekompresi gagal");
-                    }
-                    processedData.assign(decompressedData.begin(), decompressedData.end());
-                }
-                else {
-                    processedData = std::move(fileData);
-                }
+void ArchPacker::CollectFolder(const std::string& folderPath,
+    std::vector<ManifestEntry>& manifest) {
+    ArchScanner::ScanFolder(folderPath, manifest);
+}
 
-                std::ofstream outFile(filePath, std::ios::binary);
-                if (!outFile) {
-                    throw std::runtime_error("Gagal membuat file output");
-                }
-                outFile.write(reinterpret_cast<const char*>(processedData.data()), processedData.size());
+void ArchPacker::PrepareEntry(const ManifestEntry& item,
+    bool enableCompression,
+    const ArchOverlay* deltaBase,
+    ArchScheduler* scheduler,
+    PreparedEntry& prepared) const {
+    FileEntry& entry = prepared.entry;
+    memset(&entry, 0, sizeof(entry));
+    strncpy_s(entry.filename, item.archivePath.c_str(), ArchConstants::MAX_FILENAME_LENGTH - 1);
 
+    if (item.tombstone) {
+        entry.flags = FileEntry::FLAG_TOMBSTONE;
+        entry.timestamp = item.timestamp;
+        prepared.outcome = PreparedEntry::TOMBSTONE;
+        return;
+    }
 
-                auto ftime = std::chrono::system_clock::from_time_t(entry.timestamp);
-                auto fsTime = std::chrono::time_point_cast<fs::file_time_type::duration>(
-                    ftime - std::chrono::system_clock::now() + fs::file_time_type::clock::now());
-                fs::last_write_time(filePath, fsTime);
+    std::vector<uint8_t> buffer;
+    if (item.data) {
+        buffer = *item.data;
+    }
+    else {
+        std::ifstream in(item.sourcePath, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw std::runtime_error("Tidak bisa membuka file: " + item.sourcePath);
+        }
+        std::streamoff length = in.tellg();
+        if (length < 0) {
+            throw std::runtime_error("Gagal membaca file: " + item.sourcePath);
+        }
+        if (static_cast<uint64_t>(length) > UINT32_MAX) {
+            throw std::runtime_error("File melebihi batas 4 GB format archive");
+        }
+        buffer.resize(static_cast<size_t>(length));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        if (static_cast<size_t>(in.gcount()) != buffer.size()) {
+            throw std::runtime_error("Gagal membaca file: " + item.sourcePath);
+        }
+    }
 
-                successCount++;
-            }
-            catch (const std::exception& e) {
-                std::cerr << "    ERROR: " << e.what() << "\n";
-                continue;
+    ArchOverlay::Location baseLocation;
+    if (deltaBase && deltaBase->FindEntry(item.archivePath, baseLocation)) {
+        EntryCache::Handle base;
+        try {
+            base = deltaBase->ReadEntryData(baseLocation, m_encryptionKey, scheduler);
+        }
+        catch (const std::exception& e) {
+            prepared.warning = "Warning: Base " + item.archivePath + " tidak terbaca (" +
+                e.what() + "), file ditulis utuh";
+        }
+        if (base && base->size() == buffer.size() &&
+            std::equal(base->begin(), base->end(), buffer.begin())) {
+            prepared.outcome = PreparedEntry::UNCHANGED;
+            return;
+        }
+        if (base) {
+            // Checksum dan ukuran entry berlaku untuk payload delta, sehingga
+            // -t tetap bisa memverifikasi archive patch tanpa base-nya
+            std::vector<uint8_t> delta;
+            ArchDelta::Encode(base->data(), base->size(), buffer.data(), buffer.size(), delta);
+            if (delta.size() < buffer.size()) {
+                buffer.swap(delta);
+                entry.flags |= FileEntry::FLAG_DELTA;
             }
         }
+    }
 
-        std::cout << "\nEkstraksi selesai!\n";
-        std::cout << "  File berhasil diekstrak: " << successCount << "/" << totalFiles << "\n";
+    entry.size = static_cast<uint32_t>(buffer.size());
+    entry.timestamp = item.timestamp;
 
-        if (encryptedFiles > 0) {
-            if (m_encryptionKey.empty()) {
-                std::cout << "  PERINGATAN: " << encryptedFiles
-                    << " file terenkripsi TIDAK diproses (perlu passphrase)\n";
-            }
-            else if (hasEncryptionErrors) {
-                std::cout << "  PERINGATAN: Beberapa file terenkripsi gagal diproses\n";
-            }
-            else {
-                std::cout << "  " << encryptedFiles << " file terenkripsi berhasil didekripsi\n";
-            }
-        }
+    entry.checksum = ArchUtils::UpdateChecksum(0, buffer.data(), buffer.size());
 
-        return successCount > 0;
+    ArchPolicy::Settings policy = m_policy.Resolve(item.archivePath);
+    bool compress = policy.codec == ArchPolicy::Codec::Default ?
+        enableCompression : policy.codec == ArchPolicy::Codec::Deflate;
+    bool encrypt = policy.encrypt == ArchPolicy::Toggle::Default ?
+        m_useEncryption : policy.encrypt == ArchPolicy::Toggle::On;
+    if (encrypt && m_encryptionKey.empty()) {
+        throw std::runtime_error("Policy meminta enkripsi untuk " + item.archivePath +
+            " tetapi passphrase tidak diberikan");
     }
-    catch (const std::exception& e) {
-        std::cerr << "\nERROR EKSTRAKSI: " << e.what() << "\n";
-        return false;
+
+    // compressionType mencatat codec yang benar-benar dipakai: deflate yang
+    // tidak mengecilkan data tetap disimpan apa adanya
+    prepared.payload.swap(buffer);
+    if (compress) {
+        std::vector<uint8_t> compressedData;
+        uint8_t compressionType = ArchUtils::CompressData(prepared.payload, compressedData,
+            policy.level > 0 ? policy.level : Z_BEST_COMPRESSION, scheduler);
+
+        if (compressedData.size() < prepared.payload.size()) {
+            prepared.payload.swap(compressedData);
+            entry.compressionType = compressionType;
+            entry.compressedSize = static_cast<uint32_t>(prepared.payload.size());
+        }
+    }
+
+    if (encrypt) {
+        ArchCrypto::EncryptData(prepared.payload, m_encryptionKey);
+        entry.encryptionType = 1;
+    }
+    prepared.outcome = PreparedEntry::BLOB;
+}
+
+uint64_t ArchPacker::EstimatePrepareBytes(const ManifestEntry& item,
+    bool enableCompression,
+    const ArchOverlay* deltaBase) const {
+    if (item.tombstone) {
+        return 0;
+    }
+    // Tahap delta: base hasil decode dan hasil encode, paling besar seukuran file
+    uint64_t size = item.size;
+    uint64_t deltaBytes = 0;
+    ArchOverlay::Location baseLocation;
+    if (deltaBase && deltaBase->FindEntry(item.archivePath, baseLocation)) {
+        deltaBytes = deltaBase->EstimateDecodeBytes(baseLocation) + size;
+    }
+
+    // Tahap kompresi: output sebesar compressBound; CompressData berpotongan
+    // menyimpan semua potongan sekaligus sebelum digabung ke output
+    uint64_t compressBytes = 0;
+    ArchPolicy::Settings policy = m_policy.Resolve(item.archivePath);
+    if (policy.codec == ArchPolicy::Codec::Default ? enableCompression : policy.codec == ArchPolicy::Codec::Deflate) {
+        uint64_t chunks = (size + ArchConstants::COMPRESS_CHUNK_SIZE - 1) / ArchConstants::COMPRESS_CHUNK_SIZE;
+        compressBytes = compressBound(static_cast<uLong>(std::min<uint64_t>(size, UINT32_MAX))) + chunks * 16;
+        if (chunks > 1) {
+            compressBytes *= 2;
+        }
+    }
+    return size + std::max(deltaBytes, compressBytes);
+}
+
+void ArchPacker::WritePrepared(PreparedEntry& prepared,
+    std::ostream& out,
+    std::vector<FileEntry>& entries) {
+    if (!prepared.warning.empty()) {
+        std::cerr << prepared.warning << "\n";
+    }
+
+    FileEntry& entry = prepared.entry;
+    switch (prepared.outcome) {
+    case PreparedEntry::FAILED:
+        throw std::runtime_error(prepared.error);
+    case PreparedEntry::UNCHANGED:
+        m_unchangedFiles++;
+        return;
+    case PreparedEntry::TOMBSTONE:
+        if (m_localHeaders) {
+            LocalEntryHeader local;
+            local.entry = entry;
+            local.entry.offset = CurrentOffset() + static_cast<uint32_t>(sizeof(local));
+            WriteData(out, &local, sizeof(local));
+        }
+        entry.offset = CurrentOffset();
+        entries.push_back(entry);
+        return;
+    case PreparedEntry::BLOB:
+        break;
+    }
+
+    if (entry.flags & FileEntry::FLAG_DELTA) {
+        m_deltaFiles++;
+    }
+    WriteBlob(out, entry, prepared.payload.data(), prepared.payload.size());
+    entries.push_back(entry);
+}
+
+void ArchPacker::PackInOrder(const std::vector<ManifestEntry>& manifest,
+    size_t begin,
+    bool enableCompression,
+    const ArchOverlay* deltaBase,
+    const std::function<void(size_t, PreparedEntry&)>& write) {
+    struct Batch {
+        size_t begin;
+        uint64_t reserved;
+        std::vector<PreparedEntry> results;
+        ArchScheduler::Group group;
+    };
+
+    // Dideklarasikan sebelum scheduler: jika write melempar, scheduler
+    // menunggu tugas yang masih berjalan sebelum batch dibebaskan
+    std::deque<std::unique_ptr<Batch>> pending;
+    ArchScheduler scheduler;
+    ArchMemoryBudget budget(m_maxMemory);
+    const size_t maxPending = 4 * scheduler.GetWorkerCount();
+    size_t next = begin;
+
+    // File kecil digabung per batch agar overhead per tugas tidak dominan;
+    // file besar menjadi batch sendiri dan dipecah lagi oleh CompressData.
+    // Batch memesan puncak PrepareEntry setiap filenya (EstimatePrepareBytes).
+    // Hanya thread ini yang membebaskan anggaran (setelah menulis), sehingga
+    // saat penuh ia tidak memblokir tetapi menulis batch terdepan dulu.
+    auto submitBatch = [&]() {
+        size_t end = next;
+        uint64_t bytes = 0;
+        uint64_t reserved = 0;
+        do {
+            bytes += manifest[end].size;
+            reserved += EstimatePrepareBytes(manifest[end], enableCompression, deltaBase);
+            ++end;
+        } while (end < manifest.size() && end - next < ArchConstants::TASK_BATCH_FILES &&
+            bytes + manifest[end].size <= ArchConstants::TASK_BATCH_BYTES);
+        if (!budget.TryAcquire(reserved)) {
+            return false;
+        }
+
+        std::unique_ptr<Batch> batch(new Batch());
+        batch->begin = next;
+        batch->reserved = reserved;
+        batch->results.resize(end - next);
+        next = end;
+
+        Batch* raw = batch.get();
+        scheduler.Submit(raw->group, [this, raw, &manifest, enableCompression, deltaBase, &scheduler]() {
+            for (size_t i = 0; i < raw->results.size(); ++i) {
+                PreparedEntry& prepared = raw->results[i];
+                try {
+                    PrepareEntry(manifest[raw->begin + i], enableCompression, deltaBase, &scheduler, prepared);
+                }
+                catch (const std::exception& e) {
+                    prepared.outcome = PreparedEntry::FAILED;
+                    prepared.error = e.what();
+                }
+            }
+        });
+        pending.push_back(std::move(batch));
+        return true;
+    };
+
+    // Penulis tetap berurutan: batch terdepan ditunggu lalu ditulis, sementara
+    // batch berikutnya disiapkan worker sesuai urutan Submit
+    while (next < manifest.size() || !pending.empty()) {
+        while (next < manifest.size() && pending.size() < maxPending && submitBatch()) {
+        }
+        Batch& batch = *pending.front();
+        scheduler.Wait(batch.group);
+        for (size_t i = 0; i < batch.results.size(); ++i) {
+            write(batch.begin + i, batch.results[i]);
+            std::vector<uint8_t>().swap(batch.results[i].payload);
+        }
+        budget.Release(batch.reserved);
+        pending.pop_front();
+    }
+
+    if (manifest.size() > begin) {
+        scheduler.Report(std::clog, "pack");
+        if (m_maxMemory > 0) {
+            std::clog << "Memori: puncak " << (budget.GetPeak() >> 20) << " dari "
+                << (m_maxMemory >> 20) << " MB, pembacaan tertahan " << budget.GetWaitCount() << " kali\n";
+        }
+    }
+}
+
+void ArchPacker::WriteBlob(std::ostream& out, FileEntry& entry, const void* data, size_t size) {
+    // Padding diletakkan tepat sebelum blob (setelah local header), sehingga
+    // yang jatuh di batas alignment adalah data blob itu sendiri
+    entry.flags |= FileEntry::FLAG_BLOCK_CHECKSUMS;
+
+    uint32_t alignment = GetAlignment(entry.filename);
+    uint64_t blobStart = m_writePos + (m_localHeaders ? sizeof(LocalEntryHeader) : 0);
+    uint64_t padding = (alignment - blobStart % alignment) % alignment;
+
+    if (m_localHeaders) {
+        // offset dihitung setelah local header, jadi sama dengan yang ada di index
+        LocalEntryHeader local;
+        local.entry = entry;
+        local.entry.offset = CurrentOffset() + static_cast<uint32_t>(sizeof(local) + padding);
+        WriteData(out, &local, sizeof(local));
+    }
+
+    static const char zeros[4096] = {};
+    for (uint64_t left = padding; left > 0; ) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(left, sizeof(zeros)));
+        WriteData(out, zeros, count);
+        left -= count;
+    }
+    m_paddingBytes += padding;
+
+    entry.offset = CurrentOffset();
+    WriteData(out, data, size);
+
+    // Tabel CRC blok langsung setelah blob; local header berikutnya menyusul
+    std::vector<uint32_t> blocks;
+    ArchUtils::UpdateBlockChecksums(blocks, 0, static_cast<const uint8_t*>(data), size,
+        ArchConstants::CHECK_BLOCK_SIZE);
+    if (!blocks.empty()) {
+        WriteData(out, blocks.data(), blocks.size() * sizeof(uint32_t));
+    }
+}
+
+uint32_t ArchPacker::Fingerprint(const std::vector<ManifestEntry>& manifest, bool enableCompression) const {
+    // Semua yang menentukan isi archive; melanjutkan journal dengan nilai
+    // berbeda akan menghasilkan archive campuran
+    uLong crc = crc32(0, Z_NULL, 0);
+    auto add = [&crc](const void* data, size_t size) {
+        crc = crc32(crc, static_cast<const Bytef*>(data), static_cast<uInt>(size));
+    };
+
+    uint32_t options[] = { enableCompression, m_useEncryption, m_streamingLayout, m_localHeaders, m_alignment };
+    add(options, sizeof(options));
+    add(m_encryptionKey.data(), m_encryptionKey.size());
+    for (const auto& extension : m_extensionAlignment) {
+        add(extension.first.c_str(), extension.first.size() + 1);
+        add(&extension.second, sizeof(extension.second));
+    }
+    for (const auto& base : m_deltaBases) {
+        add(base.c_str(), base.size() + 1);
+    }
+    std::string policy = m_policy.Describe();
+    add(policy.data(), policy.size());
+    for (const auto& item : manifest) {
+        add(item.archivePath.c_str(), item.archivePath.size() + 1);
+        uint64_t values[] = { item.size, item.timestamp, item.tombstone };
+        add(values, sizeof(values));
+    }
+    return static_cast<uint32_t>(crc);
+}
+
+uint32_t ArchPacker::GetAlignment(const char* archivePath) const {
+    if (!m_policy.Empty()) {
+        uint32_t alignment = m_policy.Resolve(archivePath,
+            strnlen(archivePath, ArchConstants::MAX_FILENAME_LENGTH)).alignment;
+        if (alignment != 0) {
+            return alignment;
+        }
+    }
+    if (!m_extensionAlignment.empty()) {
+        std::string extension = fs::path(archivePath).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        auto found = m_extensionAlignment.find(extension);
+        if (found != m_extensionAlignment.end()) {
+            return found->second;
+        }
+    }
+    return m_alignment;
+}
+
+void ArchPacker::SetAlignment(uint32_t alignment, const std::string& extension) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("Alignment harus pangkat dua: " + std::to_string(alignment));
+    }
+    if (extension.empty()) {
+        m_alignment = alignment;
+        return;
+    }
+
+    std::string key = extension[0] == '.' ? extension : "." + extension;
+    std::transform(key.begin(), key.end(), key.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    m_extensionAlignment[key] = alignment;
+}
+
+namespace {
+    // Membandingkan CRC blok hasil hitung dengan tabel di archive; mengembalikan
+    // daftar blok rusak beserta offset-nya, atau string kosong jika semua cocok
+    std::string DescribeBadBlocks(const FileEntry& entry, const std::vector<uint32_t>& computed,
+        const std::vector<uint32_t>& expected, uint32_t blockSize) {
+        std::string result;
+        size_t badCount = 0;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (i < computed.size() && computed[i] == expected[i]) {
+                continue;
+            }
+            if (++badCount <= 4) {
+                result += (result.empty() ? "" : ", ") + std::to_string(i) + " @" +
+                    std::to_string(static_cast<uint64_t>(entry.offset) + i * static_cast<uint64_t>(blockSize));
+            }
+        }
+        if (badCount == 0) {
+            return result;
+        }
+        if (badCount > 4) {
+            result += ", ...";
+        }
+        return "Checksum blok tidak cocok: " + std::to_string(badCount) + " dari " +
+            std::to_string(expected.size()) + " blok rusak (blok " + result + ")";
+    }
+}
+
+bool ArchPacker::ExtractArchive(const std::string& inputFile,
+    const std::string& outputDir,
+    bool preserveStructure,
+    const ArchUtils::PathFilter& filter)
+{
+    return ExtractOverlay(std::vector<std::string>(1, inputFile), outputDir, preserveStructure, filter);
+}
+
+bool ArchPacker::ExtractOverlay(const std::vector<std::string>& layers,
+    const std::string& outputDir,
+    bool preserveStructure,
+    const ArchUtils::PathFilter& filter)
+{
+    try {
+        ArchOverlay overlay;
+        if (!overlay.Open(layers, m_volumeDirs)) {
+            throw std::runtime_error(overlay.GetError());
+        }
+        if (!m_accessLog.empty() && !overlay.EnableAccessLog(m_accessLog)) {
+            throw std::runtime_error(overlay.GetError());
+        }
+
+        // Filter dicocokkan langsung ke index yang di-map; hanya entry
+        // terpilih yang dibaca. GetEntries sudah urut layer lalu offset,
+        // jadi pembacaan blob di setiap file volume berjalan sekuensial.
+        std::vector<ArchOverlay::Location> entries;
+        uint32_t archiveFiles = 0;
+        for (const auto& location : overlay.GetEntries()) {
+            const FileEntry& entry = *location.entry;
+            archiveFiles++;
+            if (filter.Matches(entry.filename, strnlen(entry.filename, ArchConstants::MAX_FILENAME_LENGTH))) {
+                entries.push_back(location);
+            }
+        }
+
+        if (entries.empty()) {
+            throw std::runtime_error(archiveFiles == 0 ?
+                "Gagal membaca tabel file entries" :
+                "Tidak ada file yang cocok dengan filter");
+        }
+
+        fs::path outputPath = outputDir.empty() ? fs::path(layers.front()).stem() : fs::path(outputDir);
+        if (!fs::exists(outputPath)) {
+            fs::create_directories(outputPath);
+        }
+
+        int totalFiles = static_cast<int>(entries.size());
+        std::atomic<int> successCount(0);
+        std::atomic<int> encryptedFiles(0);
+        bool hasEncryptionErrors = false;
+
+        // Minimal satu worker per file volume (semua layer), terlepas dari
+        // jumlah core, karena disk juga diparalelkan: entry dikelompokkan per
+        // volume lalu diselang-seling sehingga setiap disk dibaca bersamaan
+        std::vector<uint32_t> volumeBase(overlay.GetLayerCount() + 1, 0);
+        for (uint32_t i = 0; i < overlay.GetLayerCount(); ++i) {
+            volumeBase[i + 1] = volumeBase[i] + overlay.GetLayer(i).GetVolumeCount();
+        }
+        auto volumeKey = [&](const ArchOverlay::Location& location) {
+            return volumeBase[location.layer] + location.entry->Volume();
+        };
+        std::stable_sort(entries.begin(), entries.end(),
+            [&](const ArchOverlay::Location& a, const ArchOverlay::Location& b) {
+                return volumeKey(a) < volumeKey(b);
+            });
+        ArchUtils::InterleaveVolumes(entries, volumeKey);
+        unsigned workerCount = std::max(std::thread::hardware_concurrency(), volumeBase.back());
+
+        std::cout << "Memulai ekstraksi " << totalFiles << " file ke: "
+            << outputPath.string() << "\n";
+        if (overlay.GetLayerCount() > 1) {
+            std::cout << "Overlay: " << overlay.GetLayerCount() << " layer, "
+                << archiveFiles << " file setelah digabung\n";
+        }
+        if (!filter.Empty()) {
+            std::cout << "Filter: " << totalFiles << " dari " << archiveFiles << " file dipilih\n";
+        }
+
+
+        ArchScheduler scheduler(workerCount);
+        ArchMemoryBudget budget(m_maxMemory);
+        std::mutex printLock;
+        auto extractRange = [&](size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index) {
+                const ArchOverlay::Location& location = entries[index];
+                const FileEntry& entry = *location.entry;
+                const ArchReader& reader = overlay.GetLayer(location.layer);
+                overlay.LogAccess(location);
+                try {
+                    {
+                        std::lock_guard<std::mutex> lock(printLock);
+                        std::cout << "  [" << (index + 1) << "/" << totalFiles << "] "
+                            << entry.filename;
+
+                        if (entry.encryptionType == 1) {
+                            std::cout << " [ENCRYPTED]";
+                            encryptedFiles++;
+                        }
+                        if (entry.compressionType != 0) {
+                            std::cout << " [COMPRESSED]";
+                        }
+                        if (entry.flags & FileEntry::FLAG_DELTA) {
+                            std::cout << " [DELTA]";
+                        }
+                        std::cout << "\n";
+                    }
+
+                    if (entry.flags & FileEntry::FLAG_DELTA) {
+                        if (entry.encryptionType == 1 && m_encryptionKey.empty()) {
+                            throw std::runtime_error("File terenkripsi tetapi passphrase tidak diberikan");
+                        }
+                        EntryCache::Handle data = overlay.ReadEntryData(location, m_encryptionKey, &scheduler);
+                        WriteExtractedFile(entry, data->data(), data->size(), outputPath.string(), preserveStructure);
+                        successCount++;
+                        continue;
+                    }
+
+                    // ReadStored memakai I/O posisional dan memverifikasi CRC blok
+                    std::vector<uint8_t> fileData(entry.compressedSize > 0 ?
+                        entry.compressedSize : entry.size);
+                    if (!reader.ReadStored(entry, 0, static_cast<uint32_t>(fileData.size()), fileData.data())) {
+                        throw std::runtime_error(reader.GetError());
+                    }
+
+                    ExtractEntry(entry, fileData, outputPath.string(), preserveStructure, &scheduler);
+
+                    successCount++;
+                }
+                catch (const std::exception& e) {
+                    std::lock_guard<std::mutex> lock(printLock);
+                    std::cerr << "    ERROR: " << entry.filename << ": " << e.what() << "\n";
+                }
+            }
+        };
+
+        // File kecil dikelompokkan per tugas; entry berpotongan yang besar
+        // memecah inflate-nya lagi ke scheduler yang sama. Setiap batch memesan
+        // byte tersimpan ditambah hasil decode-nya (dan base untuk entry delta)
+        // lalu membebaskannya sendiri
+        // setelah selesai, jadi thread ini cukup memblokir saat anggaran penuh.
+        ArchScheduler::Group group;
+        for (size_t begin = 0; begin < entries.size(); ) {
+            size_t end = begin;
+            uint64_t bytes = 0;
+            uint64_t reserved = 0;
+            do {
+                const FileEntry& entry = *entries[end].entry;
+                bytes += entry.compressedSize > 0 ? entry.compressedSize : entry.size;
+                reserved += overlay.EstimateDecodeBytes(entries[end]);
+                ++end;
+            } while (end < entries.size() && end - begin < ArchConstants::TASK_BATCH_FILES &&
+                bytes < ArchConstants::TASK_BATCH_BYTES);
+            budget.Acquire(reserved);
+            scheduler.Submit(group, [&extractRange, &budget, begin, end, reserved]() {
+                extractRange(begin, end);
+                budget.Release(reserved);
+            });
+            begin = end;
+        }
+        scheduler.Wait(group);
+
+        std::cout << "\nEkstraksi selesai!\n";
+        std::cout << "  File berhasil diekstrak: " << successCount << "/" << totalFiles << "\n";
+        std::cout << "  ";
+        scheduler.Report(std::cout, "ekstrak");
+        if (m_maxMemory > 0) {
+            std::cout << "  Memori: puncak " << (budget.GetPeak() >> 20) << " dari "
+                << (m_maxMemory >> 20) << " MB, pembacaan tertahan " << budget.GetWaitCount() << " kali\n";
+        }
+
+        if (encryptedFiles > 0) {
+            if (m_encryptionKey.empty()) {
+                std::cout << "  PERINGATAN: " << encryptedFiles
+                    << " file terenkripsi TIDAK diproses (perlu passphrase)\n";
+            }
+            else if (hasEncryptionErrors) {
+                std::cout << "  PERINGATAN: Beberapa file terenkripsi gagal diproses\n";
+            }
+            else {
+                std::cout << "  " << encryptedFiles << " file terenkripsi berhasil didekripsi\n";
+            }
+        }
+
+        return successCount > 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "\nERROR EKSTRAKSI: " << e.what() << "\n";
+        return false;
+    }
+}
+
+void ArchPacker::ExtractEntry(const FileEntry& entry,
+    std::vector<uint8_t>& fileData,
+    const std::string& outputDir,
+    bool preserveStructure,
+    ArchScheduler* scheduler) {
+    if (entry.flags & FileEntry::FLAG_DELTA) {
+        throw std::runtime_error("Entry delta butuh archive base (-x <base> --overlay <patch>)");
+    }
+
+    std::vector<uint8_t> processedData;
+    if (entry.encryptionType == 1) {
+        if (m_encryptionKey.empty()) {
+            throw std::runtime_error("File terenkripsi tetapi passphrase tidak diberikan");
+        }
+        ArchCrypto::DecryptData(fileData, m_encryptionKey); // Dekripsi sebelum dekompresi
+    }
+    if (entry.compressionType > 2) {
+        throw std::runtime_error("Tipe kompresi tidak dikenal");
+    }
+    if (entry.compressionType != 0) {
+        // Inflate langsung ke buffer akhir; payload berpotongan memakai semua core
+        processedData.resize(entry.size);
+        if (!ArchUtils::DecompressData(fileData.data(), fileData.size(), processedData.data(), entry.size,
+            scheduler)) {
+            throw std::runtime_error("Dekompresi gagal");
+        }
+    }
+    else {
+        processedData = std::move(fileData);
+    }
+
+    WriteExtractedFile(entry, processedData.data(), processedData.size(), outputDir, preserveStructure);
+}
+
+void ArchPacker::WriteExtractedFile(const FileEntry& entry,
+    const uint8_t* data, size_t size,
+    const std::string& outputDir,
+    bool preserveStructure) {
+    fs::path filePath = outputDir;
+    if (preserveStructure) {
+        filePath /= entry.filename;
+        fs::create_directories(filePath.parent_path());
+    }
+    else {
+        filePath /= fs::path(entry.filename).filename();
+    }
+
+    std::ofstream outFile(filePath, std::ios::binary);
+    if (!outFile) {
+        throw std::runtime_error("Gagal membuat file output");
+    }
+    outFile.write(reinterpret_cast<const char*>(data), size);
+    outFile.close();
+
+    auto ftime = std::chrono::system_clock::from_time_t(entry.timestamp);
+    auto fsTime = std::chrono::time_point_cast<fs::file_time_type::duration>(
+        ftime - std::chrono::system_clock::now() + fs::file_time_type::clock::now());
+    fs::last_write_time(filePath, fsTime);
+}
+
+bool ArchPacker::ExtractStream(std::istream& in,
+    const std::string& outputDir,
+    bool preserveStructure,
+    const ArchUtils::PathFilter& filter)
+{
+    try {
+        ArchHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            header.magic != ArchConstants::MAGIC) {
+            throw std::runtime_error("Format archive tidak valid atau corrupt");
+        }
+        if (header.version > ArchConstants::VERSION) {
+            throw std::runtime_error("Archive memakai format versi " + std::to_string(header.version) +
+                "; program ini hanya mendukung sampai versi " + std::to_string(ArchConstants::VERSION));
+        }
+        if ((header.flags & ArchHeader::FLAG_CHECKSUMS) && header.headerChecksum != header.ComputeChecksum()) {
+            throw std::runtime_error("Checksum header archive tidak cocok (header corrupt)");
+        }
+        if (!(header.flags & ArchHeader::FLAG_LOCAL_HEADERS)) {
+            throw std::runtime_error("Archive tidak memiliki local header; "
+                "ekstraksi sekuensial butuh archive yang dibuat dengan --local-headers");
+        }
+
+        fs::path outputPath = outputDir.empty() ? fs::path(".") : fs::path(outputDir);
+        if (!fs::exists(outputPath)) {
+            fs::create_directories(outputPath);
+        }
+
+        std::cout << "Memulai ekstraksi sekuensial ke: " << outputPath.string() << "\n";
+
+        // Pembaca hanya maju: posisi dihitung sendiri dan celah sebelum blob
+        // dilewati dengan membaca, bukan seek
+        uint64_t position = sizeof(header);
+        std::vector<char> skipBuffer(65536);
+        auto skipTo = [&](uint64_t target) {
+            while (position < target) {
+                size_t count = static_cast<size_t>(std::min<uint64_t>(skipBuffer.size(), target - position));
+                if (!in.read(skipBuffer.data(), count)) {
+                    throw std::runtime_error("Archive terpotong");
+                }
+                position += count;
+            }
+        };
+
+        int successCount = 0;
+        int failedCount = 0;
+        int skippedCount = 0;
+
+        while (true) {
+            uint32_t magic = 0;
+            if (!in.read(reinterpret_cast<char*>(&magic), sizeof(magic))) {
+                throw std::runtime_error("Archive terpotong sebelum penanda akhir");
+            }
+            position += sizeof(magic);
+            if (magic == ArchConstants::LOCAL_END_MAGIC) {
+                break;
+            }
+            if (magic != ArchConstants::LOCAL_MAGIC) {
+                throw std::runtime_error("Local header tidak valid pada offset " + std::to_string(position - sizeof(magic)));
+            }
+
+            FileEntry entry;
+            if (!in.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+                throw std::runtime_error("Archive terpotong");
+            }
+            position += sizeof(entry);
+            entry.filename[ArchConstants::MAX_FILENAME_LENGTH - 1] = '\0';
+
+            uint32_t storedSize = entry.compressedSize > 0 ? entry.compressedSize : entry.size;
+            bool hasBlocks = (entry.flags & FileEntry::FLAG_BLOCK_CHECKSUMS) && header.blockSize > 0;
+            uint32_t tableSize = hasBlocks ?
+                ArchUtils::BlockCount(storedSize, header.blockSize) * static_cast<uint32_t>(sizeof(uint32_t)) : 0;
+            if (entry.offset < position) {
+                throw std::runtime_error("Offset local header tidak valid: " + std::string(entry.filename));
+            }
+            skipTo(entry.offset);
+
+            // Tombstone tidak punya blob; penghapusan hanya berlaku lewat overlay
+            if (entry.flags & FileEntry::FLAG_TOMBSTONE) {
+                continue;
+            }
+            if (!filter.Matches(entry.filename, strlen(entry.filename))) {
+                skipTo(position + storedSize + tableSize);
+                skippedCount++;
+                continue;
+            }
+
+            std::vector<uint8_t> fileData(storedSize);
+            if (!in.read(reinterpret_cast<char*>(fileData.data()), fileData.size())) {
+                throw std::runtime_error("Archive terpotong");
+            }
+            position += storedSize;
+
+            std::vector<uint32_t> expected(tableSize / sizeof(uint32_t));
+            if (!in.read(reinterpret_cast<char*>(expected.data()), tableSize)) {
+                throw std::runtime_error("Archive terpotong");
+            }
+            position += tableSize;
+
+            try {
+                std::cout << "  [" << (successCount + failedCount + 1) << "] " << entry.filename << "\n";
+                if (hasBlocks) {
+                    std::vector<uint32_t> computed;
+                    ArchUtils::UpdateBlockChecksums(computed, 0, fileData.data(), fileData.size(), header.blockSize);
+                    std::string badBlocks = DescribeBadBlocks(entry, computed, expected, header.blockSize);
+                    if (!badBlocks.empty()) {
+                        throw std::runtime_error(badBlocks);
+                    }
+                }
+                ExtractEntry(entry, fileData, outputPath.string(), preserveStructure);
+                successCount++;
+            }
+            catch (const std::exception& e) {
+                std::cerr << "    ERROR: " << e.what() << "\n";
+                failedCount++;
+            }
+        }
+
+        std::cout << "\nEkstraksi selesai!\n";
+        std::cout << "  File berhasil diekstrak: " << successCount << "/" << (successCount + failedCount) << "\n";
+        if (skippedCount > 0) {
+            std::cout << "  File dilewati filter: " << skippedCount << "\n";
+        }
+        return failedCount == 0 && successCount > 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "\nERROR EKSTRAKSI: " << e.what() << "\n";
+        return false;
+    }
+}
+
+bool ArchPacker::StreamEntry(const std::string& inputFile,
+    const std::string& entryName,
+    std::ostream& out)
+{
+    try {
+        ArchReader reader;
+        if (!reader.Open(inputFile, m_volumeDirs)) {
+            throw std::runtime_error(reader.GetError());
+        }
+        if (!m_accessLog.empty() && !reader.EnableAccessLog(m_accessLog)) {
+            throw std::runtime_error(reader.GetError());
+        }
+
+        const FileEntry* found = reader.FindEntry(entryName);
+        if (!found) {
+            throw std::runtime_error("File tidak ditemukan di archive: " + entryName);
+        }
+        if (found->flags & FileEntry::FLAG_DELTA) {
+            throw std::runtime_error("Entry delta butuh archive base; ekstrak dengan -x <base> --overlay " + inputFile);
+        }
+        auto sink = [&](const uint8_t* data, size_t size) {
+            if (!out.write(reinterpret_cast<const char*>(data), size)) {
+                throw std::runtime_error("Gagal menulis output");
+            }
+        };
+        if (!reader.ReadEntry(*found, m_encryptionKey, sink)) {
+            throw std::runtime_error(reader.GetError());
+        }
+        out.flush();
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return false;
+    }
+}
+
+bool ArchPacker::VerifyFile(const std::string& filePath, bool quick) const {
+    try {
+        ArchReader reader;
+        if (!reader.Open(filePath, m_volumeDirs)) {
+            throw std::runtime_error(reader.GetError());
+        }
+
+        std::vector<FileEntry> entries;
+        entries.reserve(reader.GetEntryCount());
+        for (uint32_t i = 0; i < reader.GetEntryCount(); ++i) {
+            entries.push_back(reader.GetEntry(i));
+        }
+        uint32_t blockSize = reader.GetHeader().blockSize;
+        std::vector<std::string> volumePaths;
+        for (uint32_t v = 0; v < reader.GetVolumeCount(); ++v) {
+            volumePaths.push_back(reader.GetVolumePath(v));
+        }
+        reader.Close();
+
+        // Mode cepat tidak mendekripsi entry yang punya tabel CRC blok
+        if (m_encryptionKey.empty() && std::any_of(entries.begin(), entries.end(),
+            [&](const FileEntry& entry) {
+                return entry.encryptionType == 1 &&
+                    !(quick && (entry.flags & FileEntry::FLAG_BLOCK_CHECKSUMS) && blockSize > 0);
+            })) {
+            throw std::runtime_error("Archive terenkripsi tetapi passphrase tidak diberikan");
+        }
+
+        // Blob diperiksa menurut urutan di disk agar pembacaan tetap mendekati
+        // sekuensial; antar volume diselang-seling supaya semua disk terpakai
+        std::sort(entries.begin(), entries.end(), [](const FileEntry& a, const FileEntry& b) {
+            return a.Volume() != b.Volume() ? a.Volume() < b.Volume() : a.offset < b.offset;
+        });
+        ArchUtils::InterleaveVolumes(entries, [](const FileEntry& entry) { return entry.Volume(); });
+
+        std::vector<HANDLE> volumes;
+        auto closeVolumes = [&volumes]() {
+            for (HANDLE handle : volumes) {
+                CloseHandle(handle);
+            }
+            volumes.clear();
+        };
+        for (const auto& path : volumePaths) {
+            HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_OVERLAPPED, NULL);
+            if (handle == INVALID_HANDLE_VALUE) {
+                closeVolumes();
+                throw std::runtime_error("Gagal membuka file archive: " + path);
+            }
+            volumes.push_back(handle);
+        }
+
+        std::atomic<size_t> nextEntry(0);
+        std::atomic<uint64_t> storedBytes(0);
+        std::atomic<uint64_t> dataBytes(0);
+        std::mutex errorLock;
+        std::vector<std::pair<std::string, std::string>> corrupt;
+
+        auto worker = [&]() {
+            std::vector<uint8_t> stored;
+            std::vector<uint32_t> computed;
+            uint8_t buffer[65536];
+            size_t index;
+            while ((index = nextEntry++) < entries.size()) {
+                const FileEntry& entry = entries[index];
+                uint32_t storedSize = entry.compressedSize > 0 ? entry.compressedSize : entry.size;
+                bool hasBlocks = (entry.flags & FileEntry::FLAG_BLOCK_CHECKSUMS) && blockSize > 0;
+                uint32_t consumed = 0;
+                uint64_t produced = 0;
+                std::string failure;
+                stored.clear();
+                computed.clear();
+                HANDLE in = entry.Volume() < volumes.size() ?
+                    volumes[entry.Volume()] : INVALID_HANDLE_VALUE;
+
+                // Membaca byte tersimpan berikutnya; CRC blok dihitung di sini,
+                // sebelum dekripsi, karena tabel mencakup byte apa adanya di disk
+                auto readStored = [&](uint8_t* target, uint32_t count) {
+                    size_t got = 0;
+                    if (!ArchUtils::ReadAt(in, static_cast<uint64_t>(entry.offset) + consumed, target, count, &got) ||
+                        got != count) {
+                        throw std::runtime_error("Data archive terpotong");
+                    }
+                    if (hasBlocks) {
+                        ArchUtils::UpdateBlockChecksums(computed, consumed, target, count, blockSize);
+                    }
+                    consumed += count;
+                };
+
+                try {
+                    if (in == INVALID_HANDLE_VALUE) {
+                        throw std::runtime_error("Volume entry di luar jumlah volume archive");
+                    }
+                    if (entry.compressionType > 2) {
+                        throw std::runtime_error("Tipe kompresi tidak dikenal");
+                    }
+
+                    size_t storedPos = 0;
+                    if (entry.encryptionType == 1 && !(quick && hasBlocks)) {
+                        stored.resize(storedSize);
+                        readStored(stored.data(), storedSize);
+                        ArchCrypto::DecryptData(stored, m_encryptionKey);
+                    }
+
+                    auto source = [&](uint8_t* target, size_t capacity) -> size_t {
+                        size_t count = std::min<size_t>(capacity,
+                            stored.empty() ? storedSize - consumed : stored.size() - storedPos);
+                        if (count == 0) return 0;
+                        if (!stored.empty()) {
+                            memcpy(target, stored.data() + storedPos, count);
+                            storedPos += count;
+                        }
+                        else {
+                            readStored(target, static_cast<uint32_t>(count));
+                        }
+                        return count;
+                    };
+
+                    uint32_t checksum = 0;
+                    auto sink = [&](const uint8_t* data, size_t size) {
+                        checksum = ArchUtils::UpdateChecksum(checksum, data, size);
+                        produced += size;
+                    };
+
+                    // Mode cepat: cukup CRC blok, tanpa dekripsi dan inflate
+                    if (!(quick && hasBlocks)) {
+                        if (entry.compressionType != 0) {
+                            if (!ArchUtils::DecompressStream(source, sink)) {
+                                throw std::runtime_error("Dekompresi gagal");
+                            }
+                        }
+                        else {
+                            size_t got;
+                            while ((got = source(buffer, sizeof(buffer))) > 0) {
+                                sink(buffer, got);
+                            }
+                        }
+
+                        if (produced != entry.size) {
+                            throw std::runtime_error("Ukuran tidak cocok");
+                        }
+                        if (checksum != entry.checksum) {
+                            throw std::runtime_error("Checksum tidak cocok");
+                        }
+                    }
+                }
+                catch (const std::exception& e) {
+                    failure = e.what();
+                }
+
+                if (hasBlocks) {
+                    // Sisa blob tetap di-CRC walau inflate berhenti di tengah, supaya
+                    // laporan bisa menunjuk blok yang benar-benar rusak
+                    try {
+                        while (consumed < storedSize) {
+                            readStored(buffer, std::min<uint32_t>(sizeof(buffer), storedSize - consumed));
+                        }
+                        std::vector<uint32_t> expected(ArchUtils::BlockCount(storedSize, blockSize));
+                        if (!ArchUtils::ReadAt(in, static_cast<uint64_t>(entry.offset) + storedSize,
+                            expected.data(), expected.size() * sizeof(uint32_t))) {
+                            throw std::runtime_error("Tabel checksum blok terpotong");
+                        }
+                        std::string badBlocks = DescribeBadBlocks(entry, computed, expected, blockSize);
+                        if (!badBlocks.empty()) {
+                            failure = badBlocks;
+                        }
+                    }
+                    catch (const std::exception& e) {
+                        if (failure.empty()) {
+                            failure = e.what();
+                        }
+                    }
+                }
+
+                if (failure.empty()) {
+                    storedBytes += storedSize;
+                    dataBytes += produced;
+                }
+                else {
+                    std::lock_guard<std::mutex> lock(errorLock);
+                    corrupt.push_back({ entry.filename, failure });
+                }
+            }
+        };
+
+        auto start = std::chrono::steady_clock::now();
+
+        // Inflate dan checksum dibatasi CPU, jadi satu thread per core
+        unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(entries.size(), 1)));
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        closeVolumes();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double megabytes = dataBytes / (1024.0 * 1024.0);
+        double storedMegabytes = storedBytes / (1024.0 * 1024.0);
+        double throughput = quick ? storedMegabytes : megabytes;
+
+        std::sort(corrupt.begin(), corrupt.end());
+        for (const auto& item : corrupt) {
+            std::cerr << "RUSAK: " << item.first << " (" << item.second << ")\n";
+        }
+
+        char summary[256];
+        snprintf(summary, sizeof(summary),
+            "Diperiksa %zu file: %zu OK, %zu rusak\n"
+            "Data: %.2f MB (%.2f MB tersimpan) dalam %.3f detik, %.1f MB/s, %u thread\n",
+            entries.size(), entries.size() - corrupt.size(), corrupt.size(),
+            megabytes, storedMegabytes, seconds,
+            seconds > 0 ? throughput / seconds : 0.0, threadCount);
+        std::cout << summary;
+
+        return corrupt.empty();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return false;
+    }
+}
+
+namespace {
+    void AppendJsonString(std::string& out, const char* text, size_t length) {
+        out.push_back('"');
+        for (size_t i = 0; i < length; ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c == '"' || c == '\\') {
+                out.push_back('\\');
+                out.push_back(static_cast<char>(c));
+            }
+            else if (c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            }
+            else {
+                out.push_back(static_cast<char>(c));
+            }
+        }
+        out.push_back('"');
     }
-}
\ No newline at end of file
+}
+
+bool ArchPacker::ListArchive(const std::string& inputFile,
+    const std::string& pattern,
+    bool machineReadable)
+{
+    try {
+        ArchReader reader;
+        if (!reader.Open(inputFile, m_volumeDirs)) {
+            throw std::runtime_error(reader.GetError());
+        }
+
+        ArchUtils::GlobPattern glob(pattern);
+        const uint32_t count = reader.GetEntryCount();
+
+        // Output dikumpulkan per blok agar 200k+ baris tidak menjadi 200k+ write
+        std::string out;
+        out.reserve(1 << 20);
+        auto flush = [&out]() {
+            fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        };
+
+        if (!machineReadable) {
+            char line[160];
+            snprintf(line, sizeof(line), "Archive: %s (%u file, %u volume, format v%u)\n",
+                inputFile.c_str(), count, reader.GetVolumeCount(), reader.GetHeader().version);
+            out += line;
+            snprintf(line, sizeof(line), "%12s %12s %6s %4s  %-16s  %s\n",
+                "Ukuran", "Tersimpan", "Rasio", "Flag", "Waktu", "Nama");
+            out += line;
+        }
+
+        uint32_t matched = 0;
+        uint64_t totalSize = 0;
+        uint64_t totalStored = 0;
+        time_t cachedMinute = -1;
+        char timeText[32] = "";
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const FileEntry& entry = reader.GetEntry(i);
+            size_t nameLength = strnlen(entry.filename, ArchConstants::MAX_FILENAME_LENGTH);
+            if (!glob.Empty() && !glob.Match(entry.filename, nameLength)) {
+                continue;
+            }
+
+            uint32_t stored = entry.compressedSize > 0 ? entry.compressedSize : entry.size;
+            double ratio = entry.size > 0 ? 100.0 * stored / entry.size : 100.0;
+            matched++;
+            totalSize += entry.size;
+            totalStored += stored;
+
+            char line[200];
+            if (machineReadable) {
+                out += "{\"name\":";
+                AppendJsonString(out, entry.filename, nameLength);
+                snprintf(line, sizeof(line),
+                    ",\"size\":%u,\"stored\":%u,\"offset\":%u,\"checksum\":%u,"
+                    "\"compression\":%u,\"encryption\":%u,\"deleted\":%u,\"delta\":%u,\"volume\":%u,\"mtime\":%llu}\n",
+                    entry.size, stored, entry.offset, entry.checksum,
+                    entry.compressionType, entry.encryptionType,
+                    (entry.flags & FileEntry::FLAG_TOMBSTONE) ? 1u : 0u,
+                    (entry.flags & FileEntry::FLAG_DELTA) ? 1u : 0u,
+                    entry.Volume(),
+                    static_cast<unsigned long long>(entry.timestamp));
+                out += line;
+            }
+            else {
+                // localtime_s cukup mahal; file hasil satu build biasanya
+                // berbagi menit yang sama, jadi teks waktunya di-cache
+                time_t minute = static_cast<time_t>(entry.timestamp / 60);
+                if (minute != cachedMinute) {
+                    time_t t = static_cast<time_t>(entry.timestamp);
+                    struct tm tmValue = {};
+                    localtime_s(&tmValue, &t);
+                    strftime(timeText, sizeof(timeText), "%Y-%m-%d %H:%M", &tmValue);
+                    cachedMinute = minute;
+                }
+
+                char flags[5] = {
+                    entry.compressionType != 0 ? 'C' : '-',
+                    entry.encryptionType == 1 ? 'E' : '-',
+                    (entry.flags & FileEntry::FLAG_TOMBSTONE) ? 'D' : '-',
+                    (entry.flags & FileEntry::FLAG_DELTA) ? 'P' : '-',
+                    '\0' };
+                snprintf(line, sizeof(line), "%12u %12u %5.1f%% %4s  %-16s  ",
+                    entry.size, stored, ratio, flags, timeText);
+                out += line;
+                out.append(entry.filename, nameLength);
+                out.push_back('\n');
+            }
+
+            if (out.size() > (1 << 20) - 1024) {
+                flush();
+            }
+        }
+
+        if (!machineReadable) {
+            char line[160];
+            snprintf(line, sizeof(line), "%12llu %12llu %5.1f%%       %u dari %u file\n",
+                static_cast<unsigned long long>(totalSize),
+                static_cast<unsigned long long>(totalStored),
+                totalSize > 0 ? 100.0 * totalStored / totalSize : 100.0,
+                matched, count);
+            out += line;
+        }
+        flush();
+        fflush(stdout);
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "\nERROR LISTING: " << e.what() << "\n";
+        return false;
+    }
+}
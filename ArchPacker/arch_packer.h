@@ -2,8 +2,15 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <map>
 #include "arch_struct.h"
 #include "arch_utils.h"
+#include "arch_manifest.h"
+#include "arch_journal.h"
+#include "arch_policy.h"
+#include "arch_scheduler.h"
+
+class ArchOverlay;
 
 class ArchPacker {
 public:
@@ -14,31 +21,191 @@ public:
         const std::vector<std::string>& inputFiles,
         bool enableCompression = true);
 
+    // Membuat archive dari manifest yang sudah jadi; urutan entry dipertahankan.
+    // Entry dengan data terisi diambil dari memori, bukan dari sourcePath.
+    // Archive ditulis ke <outputFile>.part lalu di-rename setelah lengkap;
+    // kemajuan dicatat di <outputFile>.journal (lihat SetResume).
+    bool CreateArchive(const std::string& outputFile,
+        const std::vector<ManifestEntry>& manifest,
+        bool enableCompression = true);
+
+    // Selalu memakai layout streaming (footer di akhir), tanpa seek
+    bool CreateArchive(std::ostream& out,
+        const std::vector<std::string>& inputFiles,
+        bool enableCompression = true);
+
     bool ExtractArchive(const std::string& inputFile,
         const std::string& outputDir = "",
-        bool preserveStructure = true);
+        bool preserveStructure = true,
+        const ArchUtils::PathFilter& filter = ArchUtils::PathFilter());
+
+    // Ekstrak tumpukan archive (base dulu, lalu patch) seolah satu archive:
+    // entry di layer belakang menang dan tombstone menghapus entry di bawahnya
+    bool ExtractOverlay(const std::vector<std::string>& layers,
+        const std::string& outputDir = "",
+        bool preserveStructure = true,
+        const ArchUtils::PathFilter& filter = ArchUtils::PathFilter());
+
+    // Ekstraksi forward-only untuk archive dengan local header (mis. dari pipe)
+    bool ExtractStream(std::istream& in,
+        const std::string& outputDir,
+        bool preserveStructure = true,
+        const ArchUtils::PathFilter& filter = ArchUtils::PathFilter());
+
+    bool StreamEntry(const std::string& inputFile,
+        const std::string& entryName,
+        std::ostream& out);
+
+    // Dekripsi, dekompresi dan checksum setiap entry secara paralel tanpa
+    // menulis output; entry rusak dilaporkan ke stderr. quick hanya memeriksa
+    // CRC blok atas data tersimpan (tanpa inflate) untuk entry yang memilikinya.
+    bool VerifyFile(const std::string& filePath, bool quick = false) const;
+
+    bool ListArchive(const std::string& inputFile,
+        const std::string& pattern = "",
+        bool machineReadable = false);
 
     bool ReadHeader(std::ifstream& in, ArchHeader& header);
     bool ReadFileEntries(std::ifstream& in, std::vector<FileEntry>& entries, uint32_t indexOffset);
 
     uint64_t CalculateTotalSize(const std::vector<std::string>& files) const;
-    void SetEncryptionKey(const std::string& passphrase);
+    // encryptAll = false: kunci hanya dipakai untuk file yang dipilih policy
+    // lewat encrypt=yes
+    void SetEncryptionKey(const std::string& passphrase, bool encryptAll = true);
+    void SetStreamingLayout(bool enable) { m_streamingLayout = enable; }
+    void SetLocalHeaders(bool enable) { m_localHeaders = enable; }
+    void SetLayoutProfile(const std::string& profileFile) { m_layoutProfile = profileFile; }
+    // Path yang ditulis sebagai tombstone, untuk archive patch di atas base
+    void SetDeletions(const std::vector<std::string>& paths) { m_deletions = paths; }
+    // Tumpukan archive base (base dulu, lalu patch sebelumnya). File yang
+    // ada di base ditulis sebagai delta jika lebih kecil; file yang identik
+    // tidak ditulis sama sekali. Archive base dibaca dengan passphrase yang sama.
+    void SetDeltaBase(const std::vector<std::string>& layers) { m_deltaBases = layers; }
+    // Lanjutkan dari checkpoint journal pembuatan sebelumnya yang terputus.
+    // Input dan opsi harus sama; file yang sudah selesai tidak diproses ulang.
+    void SetResume(bool enable) { m_resume = enable; }
+    // Archive multi-volume: blob dibagi rata ke count file (count > 1), atau
+    // volume baru dimulai setiap kali volume aktif mencapai maxBytes (satu
+    // entry tidak pernah dipecah). Index tetap di file output. Tidak bisa
+    // digabung dengan SetResume.
+    void SetVolumeCount(uint32_t count) { m_volumeCount = count; }
+    void SetVolumeSize(uint64_t maxBytes) { m_volumeSize = maxBytes; }
+    // Saat membuat, volume ke-n ditaruh di dirs[(n - 1) % dirs.size()]; saat
+    // membaca, direktori ini dicari jika volume tidak ada di samping archive
+    void SetVolumeDirectories(const std::vector<std::string>& dirs) { m_volumeDirs = dirs; }
+    // Urutan file yang dibaca StreamEntry dan ExtractOverlay dicatat ke
+    // logFile, sebagai input SetLayoutProfile saat archive dibuat ulang
+    void SetAccessLog(const std::string& logFile) { m_accessLog = logFile; }
+    // Offset blob dibulatkan ke kelipatan alignment (pangkat dua); extension
+    // kosong berarti default untuk semua file, mis. SetAlignment(4096, ".dds")
+    void SetAlignment(uint32_t alignment, const std::string& extension = "");
+    // Codec, level, alignment dan enkripsi per file; pengaturan yang tidak
+    // ditulis policy mengikuti enableCompression, SetAlignment dan passphrase
+    void SetPolicy(const ArchPolicy& policy) { m_policy = policy; }
+    // Batas byte buffer yang diproses paralel saat pack dan ekstrak (0 = tanpa
+    // batas). Jika penuh, file berikutnya baru dibaca setelah blob sebelumnya
+    // ditulis; satu file yang lebih besar dari batas diproses sendirian.
+    void SetMaxMemory(uint64_t maxBytes) { m_maxMemory = maxBytes; }
+    uint64_t GetPaddingBytes() const { return m_paddingBytes; }
+    // Pesan error terakhir dari CreateArchive
+    const std::string& GetError() const { return m_error; }
+    // File yang gagal dikemas ("path: pesan") pada CreateArchive terakhir.
+    // CreateArchive tetap berhasil tetapi file tersebut tidak ada di archive.
+    const std::vector<std::string>& GetFailures() const { return m_failures; }
 
 private:
-    void WriteHeader(std::ofstream& out, uint32_t fileCount, uint32_t indexOffset);
-    void ProcessFile(const std::string& filePath,
-        std::ofstream& out,
-        std::vector<FileEntry>& entries,
+    std::vector<ManifestEntry> BuildManifest(const std::vector<std::string>& inputFiles);
+    // Dengan journal, progress berisi checkpoint yang dilanjutkan dan
+    // diperbarui selama penulisan
+    void WriteArchive(std::ostream& out,
+        const std::vector<ManifestEntry>& manifest,
+        bool enableCompression,
+        bool streamed,
+        ArchJournal* journal = nullptr,
+        ArchJournal::State* progress = nullptr);
+    void WriteStoredArchive(const std::string& outputFile,
+        const std::vector<ManifestEntry>& manifest,
+        bool streamed);
+    void WriteVolumes(const std::string& outputFile,
+        const std::vector<ManifestEntry>& manifest,
         bool enableCompression);
-    void ProcessFolder(const std::string& folderPath,
-        std::ofstream& out,
-        std::vector<FileEntry>& entries,
+    std::unique_ptr<ArchOverlay> OpenDeltaBase() const;
+    void WriteHeader(std::ostream& out, uint32_t fileCount, uint32_t indexOffset,
+        uint32_t flags = 0, uint32_t indexChecksum = 0,
+        uint32_t volumeCount = 0, uint32_t volumeSetId = 0);
+    void WriteData(std::ostream& out, const void* data, size_t size);
+    uint32_t CurrentOffset() const;
+    void CollectFile(const std::string& filePath,
+        std::vector<ManifestEntry>& manifest);
+    void CollectFolder(const std::string& folderPath,
+        std::vector<ManifestEntry>& manifest);
+    // Hasil baca, delta, kompresi dan enkripsi satu item manifest yang
+    // menunggu giliran ditulis
+    struct PreparedEntry {
+        enum Outcome { BLOB, TOMBSTONE, UNCHANGED, FAILED };
+        FileEntry entry;
+        std::vector<uint8_t> payload;
+        Outcome outcome = FAILED;
+        std::string warning;
+        std::string error;
+    };
+    // Tahap paralel: tidak menyentuh output maupun counter packer
+    void PrepareEntry(const ManifestEntry& item,
+        bool enableCompression,
+        const ArchOverlay* deltaBase,
+        ArchScheduler* scheduler,
+        PreparedEntry& prepared) const;
+    // Puncak byte yang dipakai PrepareEntry untuk item: buffer baca ditambah
+    // tahap delta atau kompresi yang paling besar
+    uint64_t EstimatePrepareBytes(const ManifestEntry& item,
+        bool enableCompression,
+        const ArchOverlay* deltaBase) const;
+    // Tahap berurutan; melempar error dari PrepareEntry untuk item yang gagal
+    void WritePrepared(PreparedEntry& prepared,
+        std::ostream& out,
+        std::vector<FileEntry>& entries);
+    // Menyiapkan manifest[begin..] di scheduler work-stealing dan memanggil
+    // write(index, prepared) berurutan di thread pemanggil
+    void PackInOrder(const std::vector<ManifestEntry>& manifest,
+        size_t begin,
         bool enableCompression,
-        const std::string& relativePath = "");
-    bool VerifyFile(const std::string& filePath) const;
+        const ArchOverlay* deltaBase,
+        const std::function<void(size_t, PreparedEntry&)>& write);
+    void WriteBlob(std::ostream& out, FileEntry& entry, const void* data, size_t size);
+    uint32_t GetAlignment(const char* archivePath) const;
+    uint32_t Fingerprint(const std::vector<ManifestEntry>& manifest, bool enableCompression) const;
+    void ExtractEntry(const FileEntry& entry,
+        std::vector<uint8_t>& fileData,
+        const std::string& outputDir,
+        bool preserveStructure,
+        ArchScheduler* scheduler = nullptr);
+    void WriteExtractedFile(const FileEntry& entry,
+        const uint8_t* data, size_t size,
+        const std::string& outputDir,
+        bool preserveStructure);
     std::vector<uint8_t> m_encryptionKey;
     bool m_useEncryption;
     bool m_printedKeyOnce = false;
+    bool m_streamingLayout;
+    bool m_localHeaders;
+    bool m_resume;
+    std::string m_layoutProfile;
+    std::vector<std::string> m_deletions;
+    std::vector<std::string> m_deltaBases;
+    uint32_t m_volumeCount;
+    uint64_t m_volumeSize;
+    uint64_t m_maxMemory;
+    std::vector<std::string> m_volumeDirs;
+    std::string m_accessLog;
+    uint32_t m_deltaFiles;
+    uint32_t m_unchangedFiles;
+    uint32_t m_alignment;
+    std::map<std::string, uint32_t> m_extensionAlignment;
+    ArchPolicy m_policy;
+    uint64_t m_writePos;
+    uint64_t m_paddingBytes;
+    std::string m_error;
+    std::vector<std::string> m_failures;
 
     ArchPacker(const ArchPacker&) = delete;
     ArchPacker& operator=(const ArchPacker&) = delete;
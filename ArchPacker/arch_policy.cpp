@@ -0,0 +1,184 @@
+#include "stdafx.h"
+#include "arch_policy.h"
+#include <sstream>
+
+namespace {
+    std::string ToLower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    // extension sudah huruf kecil dan diawali titik
+    bool HasExtension(const char* path, size_t length, const std::string& extension) {
+        if (length < extension.size()) {
+            return false;
+        }
+        const char* suffix = path + length - extension.size();
+        for (size_t i = 0; i < extension.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(suffix[i])) != extension[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void ArchPolicy::Load(const std::string& policyFile) {
+    std::ifstream in(policyFile);
+    if (!in) {
+        throw std::runtime_error("Gagal membuka file policy: " + policyFile);
+    }
+
+    std::vector<Rule> rules;
+    std::string line;
+    for (unsigned lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        auto fail = [&](const std::string& message) {
+            throw std::invalid_argument(policyFile + ":" + std::to_string(lineNumber) + ": " + message);
+        };
+
+        std::istringstream tokens(line);
+        Rule rule;
+        if (!(tokens >> rule.pattern) || rule.pattern[0] == '#') {
+            continue;
+        }
+        if (rule.pattern[0] == '.' && rule.pattern.find_first_of("/*?[") == std::string::npos) {
+            rule.pattern = "*" + rule.pattern;
+        }
+        // Aturan ekstensi dicocokkan seperti ArchPacker::GetAlignment: Logo.PNG juga .png
+        if (rule.pattern.size() > 2 && rule.pattern.compare(0, 2, "*.") == 0 &&
+            rule.pattern.find_first_of("/*?[", 1) == std::string::npos) {
+            rule.extension = ToLower(rule.pattern.substr(1));
+        }
+        else {
+            rule.glob = ArchUtils::GlobPattern(rule.pattern);
+        }
+
+        bool storeCodec = false;
+        std::string setting;
+        while (tokens >> setting) {
+            if (setting[0] == '#') {
+                break;
+            }
+            size_t eq = setting.find('=');
+            if (eq == std::string::npos) {
+                fail("Pengaturan harus berbentuk nama=nilai: " + setting);
+            }
+            std::string key = ToLower(setting.substr(0, eq));
+            std::string value = ToLower(setting.substr(eq + 1));
+
+            if (key == "codec") {
+                if (value == "store" || value == "none") {
+                    rule.settings.codec = Codec::Store;
+                    storeCodec = true;
+                }
+                else if (value == "deflate") {
+                    rule.settings.codec = Codec::Deflate;
+                }
+                else if (value == "lz4" || value == "zstd") {
+                    fail("Codec " + value + " tidak tersedia; gunakan codec=deflate level=1 untuk kompresi cepat");
+                }
+                else {
+                    fail("Codec tidak dikenal: " + value);
+                }
+            }
+            else if (key == "level") {
+                char* end = nullptr;
+                long level = strtol(value.c_str(), &end, 10);
+                if (value.empty() || *end != '\0' || level < 1 || level > 9) {
+                    fail("Level harus antara 1 dan 9: " + value);
+                }
+                rule.settings.level = static_cast<int>(level);
+            }
+            else if (key == "align") {
+                char* end = nullptr;
+                unsigned long alignment = strtoul(value.c_str(), &end, 10);
+                if (value.empty() || *end != '\0' || alignment == 0 || alignment > (1u << 24) || (alignment & (alignment - 1)) != 0) {
+                    fail("Alignment harus pangkat dua antara 1 dan 16 MB: " + value);
+                }
+                rule.settings.alignment = static_cast<uint32_t>(alignment);
+            }
+            else if (key == "encrypt") {
+                if (value == "yes" || value == "on" || value == "1") {
+                    rule.settings.encrypt = Toggle::On;
+                }
+                else if (value == "no" || value == "off" || value == "0") {
+                    rule.settings.encrypt = Toggle::Off;
+                }
+                else {
+                    fail("Nilai encrypt harus yes atau no: " + value);
+                }
+            }
+            else if (key == "solid") {
+                fail("Solid group tidak didukung: setiap entry disimpan sebagai blob terpisah");
+            }
+            else {
+                fail("Pengaturan tidak dikenal: " + key);
+            }
+        }
+
+        if (storeCodec && rule.settings.level != 0) {
+            fail("level hanya berlaku untuk codec=deflate");
+        }
+        // Level tanpa codec berarti deflate, juga saat -nc
+        if (rule.settings.level != 0) {
+            rule.settings.codec = Codec::Deflate;
+        }
+        rules.push_back(std::move(rule));
+    }
+
+    m_rules.swap(rules);
+}
+
+bool ArchPolicy::AffectsPayload() const {
+    return std::any_of(m_rules.begin(), m_rules.end(), [](const Rule& rule) {
+        return rule.settings.codec != Codec::Default || rule.settings.encrypt != Toggle::Default;
+    });
+}
+
+std::string ArchPolicy::GetEncryptPattern() const {
+    for (const auto& rule : m_rules) {
+        if (rule.settings.encrypt == Toggle::On) {
+            return rule.pattern;
+        }
+    }
+    return std::string();
+}
+
+ArchPolicy::Settings ArchPolicy::Resolve(const char* archivePath, size_t length) const {
+    Settings result;
+    for (const auto& rule : m_rules) {
+        if (!(rule.extension.empty() ? rule.glob.Match(archivePath, length) :
+            HasExtension(archivePath, length, rule.extension))) {
+            continue;
+        }
+        const Settings& settings = rule.settings;
+        if (settings.codec != Codec::Default) {
+            result.codec = settings.codec;
+            if (settings.codec == Codec::Store) {
+                result.level = 0;
+            }
+        }
+        if (settings.level != 0) {
+            result.level = settings.level;
+        }
+        if (settings.alignment != 0) {
+            result.alignment = settings.alignment;
+        }
+        if (settings.encrypt != Toggle::Default) {
+            result.encrypt = settings.encrypt;
+        }
+    }
+    return result;
+}
+
+std::string ArchPolicy::Describe() const {
+    std::string result;
+    for (const auto& rule : m_rules) {
+        const Settings& settings = rule.settings;
+        result += rule.pattern + " " + std::to_string(static_cast<int>(settings.codec)) +
+            " " + std::to_string(settings.level) + " " + std::to_string(settings.alignment) +
+            " " + std::to_string(static_cast<int>(settings.encrypt)) + "\n";
+    }
+    return result;
+}
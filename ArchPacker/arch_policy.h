@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "arch_utils.h"
+
+// Pengaturan pack per file dari file policy, satu aturan per baris:
+//   # pola        pengaturan
+//   *.png         codec=store
+//   .ogg          codec=store
+//   *.json        codec=deflate level=1
+//   *.txt         level=9
+//   textures/**   align=4096 encrypt=no
+// Pola memakai sintaks GlobPattern; ".ext" sama dengan "*.ext" dan keduanya
+// dicocokkan tanpa membedakan huruf besar/kecil, sama seperti --align. Semua aturan
+// yang cocok diterapkan berurutan dan setiap pengaturan digabung sendiri-sendiri,
+// jadi aturan di bawah hanya menimpa pengaturan yang juga ia tulis (seperti
+// .gitattributes). codec=store membuang level dari aturan sebelumnya.
+class ArchPolicy {
+public:
+    enum class Codec : uint8_t { Default, Store, Deflate };
+    enum class Toggle : uint8_t { Default, Off, On };
+
+    struct Settings {
+        Codec codec = Codec::Default;   // Default = mengikuti -c / -nc
+        int level = 0;                  // level deflate 1-9; 0 = default
+        uint32_t alignment = 0;         // 0 = mengikuti --align
+        Toggle encrypt = Toggle::Default;
+    };
+
+    // Melempar std::runtime_error jika file tidak bisa dibuka dan
+    // std::invalid_argument (dengan nomor baris) untuk aturan yang tidak valid
+    void Load(const std::string& policyFile);
+
+    bool Empty() const { return m_rules.empty(); }
+    size_t GetRuleCount() const { return m_rules.size(); }
+    // true jika ada aturan codec, level atau enkripsi, yaitu isi blob bisa
+    // berbeda dari salinan apa adanya
+    bool AffectsPayload() const;
+    // Pola aturan pertama dengan encrypt=yes, kosong jika tidak ada
+    std::string GetEncryptPattern() const;
+    Settings Resolve(const char* archivePath, size_t length) const;
+    Settings Resolve(const std::string& archivePath) const {
+        return Resolve(archivePath.data(), archivePath.size());
+    }
+    // Semua aturan dalam bentuk normal, untuk fingerprint journal
+    std::string Describe() const;
+
+private:
+    struct Rule {
+        std::string pattern;
+        ArchUtils::GlobPattern glob;
+        std::string extension; // huruf kecil dengan titik; jika ada, glob tidak dipakai
+        Settings settings;
+    };
+
+    std::vector<Rule> m_rules;
+};
@@ -0,0 +1,574 @@
+#include "stdafx.h"
+#include "arch_reader.h"
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+    thread_local std::string t_lastError;
+
+    void SetError(const std::string& message) {
+        t_lastError = message;
+    }
+}
+
+ArchReader::ArchReader()
+    : m_entries(nullptr), m_entryCount(0), m_cacheBudget(0), m_cacheShards(0), m_logging(false) {}
+ArchReader::~ArchReader() {
+    // Worker prefetch memakai index dan file, jadi harus berhenti lebih dulu
+    StopPrefetch();
+}
+
+bool ArchReader::Open(const std::string& archiveFile, const std::vector<std::string>& volumeDirs) {
+    Close();
+
+    if (!m_file.Open(archiveFile)) {
+        SetError("Gagal membuka file archive: " + archiveFile);
+        return false;
+    }
+
+    const uint8_t* headerView = m_file.Map(0, sizeof(ArchHeader));
+    if (!headerView) {
+        SetError("File terlalu kecil untuk archive: " + archiveFile);
+        return false;
+    }
+    memcpy(&m_header, headerView, sizeof(m_header));
+    if (m_header.magic != ArchConstants::MAGIC) {
+        SetError("Format archive tidak valid atau corrupt");
+        return false;
+    }
+    if (m_header.version > ArchConstants::VERSION) {
+        SetError("Archive memakai format versi " + std::to_string(m_header.version) +
+            "; program ini hanya mendukung sampai versi " + std::to_string(ArchConstants::VERSION));
+        return false;
+    }
+    bool checksums = (m_header.flags & ArchHeader::FLAG_CHECKSUMS) != 0;
+    if (checksums && (m_header.headerChecksum != m_header.ComputeChecksum() || m_header.blockSize == 0)) {
+        SetError("Checksum header archive tidak cocok (header corrupt)");
+        return false;
+    }
+
+    if (m_header.flags & ArchHeader::FLAG_STREAMED) {
+        const uint8_t* footerView = m_file.Size() >= sizeof(ArchHeader) + sizeof(ArchFooter) ?
+            m_file.Map(m_file.Size() - sizeof(ArchFooter), sizeof(ArchFooter)) : nullptr;
+        ArchFooter footer;
+        if (footerView) {
+            memcpy(&footer, footerView, sizeof(footer));
+        }
+        if (!footerView || footer.magic != ArchConstants::FOOTER_MAGIC) {
+            SetError("Footer archive streaming tidak ditemukan (archive terpotong?)");
+            return false;
+        }
+        m_header.fileCount = footer.fileCount;
+        m_header.indexOffset = footer.indexOffset;
+        m_header.indexChecksum = footer.indexChecksum;
+    }
+
+    uint64_t indexSize = static_cast<uint64_t>(m_header.fileCount) * sizeof(FileEntry);
+    if (m_header.indexOffset < sizeof(ArchHeader) ||
+        m_header.indexOffset + indexSize > m_file.Size()) {
+        SetError("Tabel file entries berada di luar batas file");
+        return false;
+    }
+
+    if (m_header.fileCount > 0) {
+        m_entries = reinterpret_cast<const FileEntry*>(
+            m_file.Map(m_header.indexOffset, static_cast<size_t>(indexSize)));
+        if (!m_entries) {
+            SetError("Gagal memetakan tabel file entries: " + ArchUtils::GetLastErrorString());
+            return false;
+        }
+    }
+    if (checksums && crc32(0, reinterpret_cast<const Bytef*>(m_entries),
+        static_cast<uInt>(indexSize)) != m_header.indexChecksum) {
+        SetError("Checksum tabel file entries tidak cocok (index corrupt)");
+        return false;
+    }
+
+    m_volumePaths.push_back(archiveFile);
+    uint32_t volumeCount = (m_header.flags & ArchHeader::FLAG_VOLUMES) ? m_header.volumeCount : 1;
+    if (volumeCount == 0 || volumeCount > FileEntry::MAX_VOLUMES) {
+        SetError("Jumlah volume archive tidak valid");
+        return false;
+    }
+    for (uint32_t i = 1; i < volumeCount; ++i) {
+        std::unique_ptr<ArchUtils::MappedFile> volume(new ArchUtils::MappedFile());
+        std::string path = ArchUtils::VolumePath(archiveFile, i);
+        bool opened = volume->Open(path);
+        for (size_t d = 0; !opened && d < volumeDirs.size(); ++d) {
+            path = (fs::path(volumeDirs[d]) / fs::path(ArchUtils::VolumePath(archiveFile, i)).filename()).string();
+            opened = volume->Open(path);
+        }
+        if (!opened) {
+            SetError("Volume " + std::to_string(i) + " tidak ditemukan: " + ArchUtils::VolumePath(archiveFile, i));
+            return false;
+        }
+
+        const uint8_t* view = volume->Map(0, sizeof(VolumeHeader));
+        VolumeHeader header;
+        if (view) {
+            memcpy(&header, view, sizeof(header));
+        }
+        if (!view || header.magic != ArchConstants::VOLUME_MAGIC ||
+            header.volumeSetId != m_header.volumeSetId || header.volume != i) {
+            SetError("Volume bukan bagian dari archive ini: " + path);
+            return false;
+        }
+        m_volumes.push_back(std::move(volume));
+        m_volumePaths.push_back(path);
+    }
+
+    m_entryCount = m_header.fileCount;
+    m_nameIndex.reset(new NameIndex());
+    return true;
+}
+
+const ArchUtils::MappedFile* ArchReader::VolumeOf(const FileEntry& entry) const {
+    uint32_t volume = entry.Volume();
+    if (volume == 0) {
+        return &m_file;
+    }
+    return volume <= m_volumes.size() ? m_volumes[volume - 1].get() : nullptr;
+}
+
+const FileEntry* ArchReader::FindEntry(const std::string& name) const {
+    // Tombstone bukan file; artinya hanya relevan untuk ArchOverlay
+    const FileEntry* entry = PeekEntry(name);
+    if (!entry || (entry->flags & FileEntry::FLAG_TOMBSTONE)) {
+        return nullptr;
+    }
+    LogAccess(*entry);
+    return entry;
+}
+
+const FileEntry* ArchReader::PeekEntry(const std::string& name) const {
+    if (!m_nameIndex || name.size() >= ArchConstants::MAX_FILENAME_LENGTH) {
+        return nullptr;
+    }
+
+    // Index dibangun sekali oleh thread pertama yang mencari; thread lain menunggu.
+    // Nama kembar memakai entry pertama, sama seperti pencarian linear sebelumnya.
+    std::call_once(m_nameIndex->built, [this]() {
+        m_nameIndex->entries.reserve(m_entryCount);
+        for (uint32_t i = 0; i < m_entryCount; ++i) {
+            const char* filename = m_entries[i].filename;
+            m_nameIndex->entries.emplace(
+                std::string_view(filename, strnlen(filename, ArchConstants::MAX_FILENAME_LENGTH)), i);
+        }
+    });
+
+    auto found = m_nameIndex->entries.find(std::string_view(name));
+    return found != m_nameIndex->entries.end() ? &m_entries[found->second] : nullptr;
+}
+
+void ArchReader::LogAccess(const FileEntry& entry) const {
+    if (!m_logging) {
+        return;
+    }
+    // m_logStart diganti setiap EnableAccessLog, jadi dibaca di bawah kunci
+    std::lock_guard<std::mutex> lock(m_logLock);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_logStart).count();
+    m_accessLog << elapsed << '\t';
+    m_accessLog.write(entry.filename, strnlen(entry.filename, ArchConstants::MAX_FILENAME_LENGTH));
+    m_accessLog << '\n';
+}
+
+const std::string& ArchReader::GetError() const {
+    return t_lastError;
+}
+
+bool ArchReader::ReadStored(const FileEntry& entry, uint32_t begin, uint32_t length, uint8_t* buffer) const {
+    uint32_t storedSize = entry.compressedSize > 0 ? entry.compressedSize : entry.size;
+    if (begin > storedSize || length > storedSize - begin) {
+        SetError("Rentang baca di luar blob: " + std::string(entry.filename));
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+
+    const ArchUtils::MappedFile* volume = VolumeOf(entry);
+    if (!volume) {
+        SetError("Volume entry di luar jumlah volume archive: " + std::string(entry.filename));
+        return false;
+    }
+    HANDLE file = volume->Handle();
+    uint32_t blockSize = m_header.blockSize;
+    if (!(entry.flags & FileEntry::FLAG_BLOCK_CHECKSUMS) || blockSize == 0) {
+        if (!ArchUtils::ReadAt(file, static_cast<uint64_t>(entry.offset) + begin, buffer, length)) {
+            SetError("Data archive terpotong: " + std::string(entry.filename));
+            return false;
+        }
+        return true;
+    }
+
+    // Hanya blok yang bersinggungan dengan rentang yang dibaca dan diperiksa
+    uint32_t first = begin / blockSize;
+    uint32_t last = (begin + length - 1) / blockSize;
+    std::vector<uint32_t> expected(last - first + 1);
+    uint64_t tableOffset = static_cast<uint64_t>(entry.offset) + storedSize + first * sizeof(uint32_t);
+    if (!ArchUtils::ReadAt(file, tableOffset, expected.data(), expected.size() * sizeof(uint32_t))) {
+        SetError("Tabel checksum blok terpotong: " + std::string(entry.filename));
+        return false;
+    }
+
+    // Blok yang seluruhnya berada di dalam rentang dibaca langsung ke buffer
+    // pemanggil; hanya blok tepi yang lewat buffer sementara milik thread ini
+    thread_local std::vector<uint8_t> scratch;
+    for (uint32_t i = first; i <= last; ++i) {
+        uint32_t blockStart = i * blockSize;
+        uint32_t blockLength = std::min(blockSize, storedSize - blockStart);
+        bool direct = blockStart >= begin && blockStart + blockLength <= begin + length;
+        uint8_t* block = buffer + (blockStart - begin);
+        if (!direct) {
+            scratch.resize(blockSize);
+            block = scratch.data();
+        }
+        if (!ArchUtils::ReadAt(file, static_cast<uint64_t>(entry.offset) + blockStart, block, blockLength)) {
+            SetError("Data archive terpotong: " + std::string(entry.filename));
+            return false;
+        }
+        if (crc32(0, block, blockLength) != expected[i - first]) {
+            SetError("Blok " + std::to_string(i) + " rusak (offset archive " +
+                std::to_string(static_cast<uint64_t>(entry.offset) + blockStart) + "): " + entry.filename);
+            return false;
+        }
+
+        if (!direct) {
+            uint32_t from = std::max(begin, blockStart);
+            uint32_t to = std::min(begin + length, blockStart + blockLength);
+            memcpy(buffer + (from - begin), block + (from - blockStart), to - from);
+        }
+    }
+    return true;
+}
+
+bool ArchReader::ReadEntry(const FileEntry& entry, const std::vector<uint8_t>& key,
+    const std::function<void(const uint8_t*, size_t)>& sink) const {
+    try {
+        if (entry.compressionType > 2) {
+            throw std::runtime_error("Tipe kompresi tidak dikenal");
+        }
+
+        // Blob dibaca lewat ReadStored, jadi setiap blok diverifikasi sebelum dipakai
+        uint32_t remaining = entry.compressedSize > 0 ? entry.compressedSize : entry.size;
+        uint32_t position = 0;
+        std::vector<uint8_t> storedData;
+        size_t storedPos = 0;
+
+        if (entry.encryptionType == 1) {
+            if (key.empty()) {
+                throw std::runtime_error("File terenkripsi tetapi passphrase tidak diberikan");
+            }
+            // Enkripsi mengacak posisi byte di seluruh blob, jadi blob tersimpan
+            // harus utuh dulu sebelum didekripsi; hasil inflate tetap di-stream
+            storedData.resize(remaining);
+            if (!ReadStored(entry, 0, remaining, storedData.data())) {
+                return false;
+            }
+            ArchCrypto::DecryptData(storedData, key);
+        }
+
+        auto source = [&](uint8_t* buffer, size_t capacity) -> size_t {
+            size_t count = std::min<size_t>(capacity, remaining);
+            if (count == 0) return 0;
+            if (!storedData.empty()) {
+                memcpy(buffer, storedData.data() + storedPos, count);
+                storedPos += count;
+            }
+            else if (!ReadStored(entry, position, static_cast<uint32_t>(count), buffer)) {
+                throw std::runtime_error(t_lastError);
+            }
+            position += static_cast<uint32_t>(count);
+            remaining -= static_cast<uint32_t>(count);
+            return count;
+        };
+
+        uint64_t written = 0;
+        uint32_t checksum = 0;
+        auto checkedSink = [&](const uint8_t* data, size_t size) {
+            checksum = ArchUtils::UpdateChecksum(checksum, data, size);
+            written += size;
+            sink(data, size);
+        };
+
+        if (entry.compressionType != 0) {
+            if (!ArchUtils::DecompressStream(source, checkedSink)) {
+                throw std::runtime_error("Dekompresi gagal");
+            }
+        }
+        else {
+            std::vector<uint8_t> buffer(65536);
+            size_t got;
+            while ((got = source(buffer.data(), buffer.size())) > 0) {
+                checkedSink(buffer.data(), got);
+            }
+        }
+
+        if (written != entry.size || checksum != entry.checksum) {
+            throw std::runtime_error("Checksum tidak cocok untuk " + std::string(entry.filename));
+        }
+        return true;
+    }
+    catch (const std::exception& e) {
+        SetError(e.what());
+        return false;
+    }
+}
+
+bool ArchReader::ReadChunkedEntry(const FileEntry& entry, const std::vector<uint8_t>& key,
+    std::vector<uint8_t>& output, ArchScheduler* scheduler) const {
+    try {
+        if (entry.encryptionType == 1 && key.empty()) {
+            throw std::runtime_error("File terenkripsi tetapi passphrase tidak diberikan");
+        }
+        std::vector<uint8_t> stored(entry.compressedSize);
+        if (!ReadStored(entry, 0, entry.compressedSize, stored.data())) {
+            return false;
+        }
+        if (entry.encryptionType == 1) {
+            ArchCrypto::DecryptData(stored, key);
+        }
+
+        output.resize(entry.size);
+        if (!ArchUtils::DecompressData(stored.data(), stored.size(), output.data(), entry.size, scheduler)) {
+            throw std::runtime_error("Dekompresi gagal");
+        }
+        if (ArchUtils::UpdateChecksum(0, output.data(), output.size()) != entry.checksum) {
+            throw std::runtime_error("Checksum tidak cocok untuk " + std::string(entry.filename));
+        }
+        return true;
+    }
+    catch (const std::exception& e) {
+        SetError(e.what());
+        return false;
+    }
+}
+
+void ArchReader::EnableCache(size_t budgetBytes, unsigned shardCount) {
+    m_cacheBudget = budgetBytes;
+    m_cacheShards = shardCount;
+    m_cache.reset(budgetBytes > 0 ? new EntryCache(budgetBytes, shardCount) : nullptr);
+}
+
+EntryCache::Handle ArchReader::ReadEntryData(const FileEntry& entry, const std::vector<uint8_t>& key,
+    ArchScheduler* scheduler) const {
+    // Key cache adalah index entry: offset tidak unik (entry kosong berbagi
+    // offset dengan blob berikutnya, volume lain punya offset sendiri). Entry
+    // kosong dan salinan FileEntry di luar index tidak di-cache.
+    bool cacheable = m_cache && entry.size > 0 &&
+        &entry >= m_entries && &entry < m_entries + m_entryCount;
+    uint64_t cacheKey = cacheable ? static_cast<uint64_t>(&entry - m_entries) : 0;
+    if (cacheable) {
+        EntryCache::Handle cached = m_cache->Find(cacheKey);
+        if (cached) {
+            return cached;
+        }
+    }
+
+    auto data = std::make_shared<std::vector<uint8_t>>();
+    if (entry.compressionType == 2) {
+        if (!ReadChunkedEntry(entry, key, *data, scheduler)) {
+            return nullptr;
+        }
+        return cacheable ? m_cache->Insert(cacheKey, data) : data;
+    }
+    try {
+        data->reserve(entry.size);
+    }
+    catch (const std::exception& e) {
+        SetError(e.what());
+        return nullptr;
+    }
+    auto sink = [&](const uint8_t* chunk, size_t size) {
+        data->insert(data->end(), chunk, chunk + size);
+    };
+    if (!ReadEntry(entry, key, sink)) {
+        return nullptr;
+    }
+    return cacheable ? m_cache->Insert(cacheKey, data) : data;
+}
+
+EntryCache::Stats ArchReader::GetCacheStats() const {
+    return m_cache ? m_cache->GetStats() : EntryCache::Stats();
+}
+
+struct ArchReader::PrefetchQueue {
+    struct Job {
+        const FileEntry* entry;
+        std::shared_ptr<const std::vector<uint8_t>> key;
+        std::promise<EntryCache::Handle> result;
+    };
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<Job> jobs;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+};
+
+std::vector<std::future<EntryCache::Handle>> ArchReader::Prefetch(const std::vector<std::string>& names,
+    const std::vector<uint8_t>& key) const {
+    std::vector<std::future<EntryCache::Handle>> results;
+    results.reserve(names.size());
+
+    std::vector<PrefetchQueue::Job> jobs;
+    auto sharedKey = std::make_shared<const std::vector<uint8_t>>(key);
+    for (const auto& name : names) {
+        PrefetchQueue::Job job;
+        job.entry = FindEntry(name);
+        job.key = sharedKey;
+        results.push_back(job.result.get_future());
+        if (!job.entry) {
+            job.result.set_exception(std::make_exception_ptr(
+                std::runtime_error("Entry tidak ditemukan: " + name)));
+            continue;
+        }
+        jobs.push_back(std::move(job));
+    }
+    if (jobs.empty()) {
+        return results;
+    }
+
+    // Urut (volume, offset) agar decode membaca setiap volume maju; blob yang
+    // berdekatan digabung menjadi satu permintaan readahead per volume
+    std::sort(jobs.begin(), jobs.end(), [](const PrefetchQueue::Job& a, const PrefetchQueue::Job& b) {
+        return a.entry->Volume() != b.entry->Volume() ?
+            a.entry->Volume() < b.entry->Volume() : a.entry->offset < b.entry->offset;
+    });
+    const uint64_t mergeGap = 256 * 1024;
+    const ArchUtils::MappedFile* rangeFile = nullptr;
+    uint64_t rangeStart = 0, rangeEnd = 0;
+    for (const auto& job : jobs) {
+        const FileEntry& entry = *job.entry;
+        const ArchUtils::MappedFile* volume = VolumeOf(entry);
+        uint64_t stored = entry.compressedSize > 0 ? entry.compressedSize : entry.size;
+        if (entry.flags & FileEntry::FLAG_BLOCK_CHECKSUMS) {
+            stored += ArchUtils::BlockCount(stored, m_header.blockSize) * sizeof(uint32_t);
+        }
+        if (rangeEnd > rangeStart && (volume != rangeFile || entry.offset > rangeEnd + mergeGap)) {
+            rangeFile->Prefetch(rangeStart, rangeEnd - rangeStart);
+            rangeStart = rangeEnd = 0;
+        }
+        if (!volume) {
+            continue;
+        }
+        if (rangeEnd == rangeStart) {
+            rangeFile = volume;
+            rangeStart = entry.offset;
+        }
+        rangeEnd = std::max(rangeEnd, entry.offset + stored);
+    }
+    if (rangeEnd > rangeStart) {
+        rangeFile->Prefetch(rangeStart, rangeEnd - rangeStart);
+    }
+    // Volume diselang-seling supaya worker membaca dari semua disk sekaligus
+    ArchUtils::InterleaveVolumes(jobs, [](const PrefetchQueue::Job& job) { return job.entry->Volume(); });
+
+    std::lock_guard<std::mutex> lock(m_prefetchLock);
+    if (!m_prefetch) {
+        m_prefetch.reset(new PrefetchQueue());
+        unsigned threadCount = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+        for (unsigned i = 0; i < threadCount; ++i) {
+            m_prefetch->workers.emplace_back(&ArchReader::PrefetchWorker, this, std::ref(*m_prefetch));
+        }
+    }
+    {
+        std::lock_guard<std::mutex> queueLock(m_prefetch->lock);
+        for (auto& job : jobs) {
+            m_prefetch->jobs.push_back(std::move(job));
+        }
+    }
+    m_prefetch->wake.notify_all();
+    return results;
+}
+
+void ArchReader::PrefetchWorker(PrefetchQueue& queue) const {
+    for (;;) {
+        PrefetchQueue::Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue.lock);
+            queue.wake.wait(lock, [&]() { return queue.stopping || !queue.jobs.empty(); });
+            if (queue.stopping) {
+                return;
+            }
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+
+        EntryCache::Handle data = ReadEntryData(*job.entry, *job.key);
+        if (data) {
+            job.result.set_value(data);
+        }
+        else {
+            job.result.set_exception(std::make_exception_ptr(std::runtime_error(GetError())));
+        }
+    }
+}
+
+void ArchReader::StopPrefetch() {
+    std::unique_ptr<PrefetchQueue> queue;
+    {
+        std::lock_guard<std::mutex> lock(m_prefetchLock);
+        queue.swap(m_prefetch);
+    }
+    if (!queue) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue->lock);
+        queue->stopping = true;
+    }
+    queue->wake.notify_all();
+    for (auto& worker : queue->workers) {
+        worker.join();
+    }
+    for (auto& job : queue->jobs) {
+        job.result.set_exception(std::make_exception_ptr(
+            std::runtime_error("Prefetch dibatalkan karena archive ditutup")));
+    }
+}
+
+bool ArchReader::EnableAccessLog(const std::string& logFile) {
+    std::lock_guard<std::mutex> lock(m_logLock);
+    if (m_accessLog.is_open()) {
+        m_accessLog.close();
+    }
+    m_accessLog.open(logFile, std::ios::app);
+    if (!m_accessLog) {
+        SetError("Gagal membuka access log: " + logFile);
+        return false;
+    }
+
+    // Setiap sesi diawali penanda agar waktu akses bisa dibandingkan antar run
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    m_accessLog << "# session " << now << '\n';
+    m_logStart = std::chrono::steady_clock::now();
+    m_logging = true;
+    return true;
+}
+
+void ArchReader::Close() {
+    StopPrefetch();
+    m_file.Close();
+    m_volumes.clear();
+    m_volumePaths.clear();
+    m_header = ArchHeader();
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_nameIndex.reset();
+    if (m_cache) {
+        m_cache.reset(new EntryCache(m_cacheBudget, m_cacheShards));
+    }
+
+    std::lock_guard<std::mutex> lock(m_logLock);
+    if (m_accessLog.is_open()) {
+        m_accessLog.flush();
+    }
+}
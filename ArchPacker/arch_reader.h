@@ -0,0 +1,115 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <future>
+#include <string_view>
+#include <unordered_map>
+#include "arch_struct.h"
+#include "arch_utils.h"
+#include "arch_cache.h"
+
+// Akses read-only ke header dan index archive lewat file mapping.
+// Data blob hanya dibaca lewat ReadStored, jadi membuka archive besar tetap murah.
+// Setelah Open, semua fungsi const aman dipanggil dari banyak thread sekaligus:
+// blob dibaca dengan I/O posisional dan inflate memakai konteks per thread.
+class ArchReader {
+public:
+    ArchReader();
+    ~ArchReader();
+
+    // Volume archive multi-volume dicari di samping archiveFile, lalu di
+    // volumeDirs (mis. volume yang dipindah ke disk lain)
+    bool Open(const std::string& archiveFile,
+        const std::vector<std::string>& volumeDirs = std::vector<std::string>());
+    void Close();
+
+    const ArchHeader& GetHeader() const { return m_header; }
+    uint32_t GetEntryCount() const { return m_entryCount; }
+    const FileEntry& GetEntry(uint32_t index) const { return m_entries[index]; }
+    // Minimal 1; volume 0 adalah file archive itu sendiri
+    uint32_t GetVolumeCount() const { return static_cast<uint32_t>(m_volumePaths.size()); }
+    const std::string& GetVolumePath(uint32_t volume) const { return m_volumePaths[volume]; }
+    // Lookup lewat hash index yang dibangun saat pertama kali dipakai;
+    // entry tombstone dianggap tidak ada
+    const FileEntry* FindEntry(const std::string& name) const;
+    // Entry mentah untuk nama, termasuk tombstone, tanpa dicatat ke access log;
+    // untuk ArchOverlay yang harus berhenti di tombstone saat mencari base delta
+    const FileEntry* PeekEntry(const std::string& name) const;
+    // Pesan error terakhir pada thread pemanggil
+    const std::string& GetError() const;
+
+    // Membaca byte tersimpan [begin, begin + length) dari blob entry. Jika entry
+    // punya tabel checksum blok, setiap blok yang tersentuh diverifikasi dulu.
+    bool ReadStored(const FileEntry& entry, uint32_t begin, uint32_t length, uint8_t* buffer) const;
+
+    // Mendekripsi (jika perlu) dan meng-inflate entry ke sink secara bertahap,
+    // lalu memverifikasi ukuran dan checksum. key kosong untuk archive tanpa enkripsi.
+    bool ReadEntry(const FileEntry& entry, const std::vector<uint8_t>& key,
+        const std::function<void(const uint8_t*, size_t)>& sink) const;
+
+    // Cache isi entry hasil decode dengan anggaran budgetBytes (0 = nonaktif).
+    // Dipanggil sebelum reader dipakai dari banyak thread; isi cache dibuang saat Close.
+    void EnableCache(size_t budgetBytes, unsigned shardCount = 16);
+    // Isi entry yang sudah didekripsi dan di-inflate, lewat cache jika aktif.
+    // Handle tetap valid walau entry-nya di-evict. nullptr jika gagal (lihat GetError).
+    // Entry berpotongan di-inflate paralel hanya jika scheduler diberikan.
+    EntryCache::Handle ReadEntryData(const FileEntry& entry, const std::vector<uint8_t>& key,
+        ArchScheduler* scheduler = nullptr) const;
+    EntryCache::Stats GetCacheStats() const;
+
+    // Decode entry di thread pool latar belakang untuk dipakai nanti. Rentang
+    // byte yang dibutuhkan langsung diminta ke OS (readahead) dan entry diproses
+    // urut offset. Hasilnya masuk cache jika aktif, sehingga ReadEntryData
+    // berikutnya langsung hit. Satu future per nama dengan urutan yang sama;
+    // get() melempar std::runtime_error jika entry tidak ada atau rusak.
+    std::vector<std::future<EntryCache::Handle>> Prefetch(const std::vector<std::string>& names,
+        const std::vector<uint8_t>& key = std::vector<uint8_t>()) const;
+
+    // Mencatat setiap FindEntry yang berhasil ke logFile (append) sebagai
+    // "<ms sejak sesi dimulai>\t<nama>", untuk packer --layout-profile
+    bool EnableAccessLog(const std::string& logFile);
+    // Mencatat akses entry ke access log (jika aktif) untuk pembaca yang tidak
+    // lewat FindEntry, mis. ekstraksi, mount dan C API per index
+    void LogAccess(const FileEntry& entry) const;
+
+private:
+    struct NameIndex {
+        std::once_flag built;
+        std::unordered_map<std::string_view, uint32_t> entries;
+    };
+    struct PrefetchQueue;
+
+    // Entry compressionType 2 dibaca utuh lalu di-inflate per potongan
+    // langsung ke output; dipakai ReadEntryData
+    bool ReadChunkedEntry(const FileEntry& entry, const std::vector<uint8_t>& key,
+        std::vector<uint8_t>& output, ArchScheduler* scheduler) const;
+    void PrefetchWorker(PrefetchQueue& queue) const;
+    void StopPrefetch();
+    // nullptr jika nomor volume entry di luar jumlah volume archive
+    const ArchUtils::MappedFile* VolumeOf(const FileEntry& entry) const;
+
+    ArchUtils::MappedFile m_file;
+    std::vector<std::unique_ptr<ArchUtils::MappedFile>> m_volumes; // volume 1 dst.
+    std::vector<std::string> m_volumePaths;
+    ArchHeader m_header;
+    const FileEntry* m_entries;
+    uint32_t m_entryCount;
+    std::unique_ptr<NameIndex> m_nameIndex;
+    std::unique_ptr<EntryCache> m_cache;
+    size_t m_cacheBudget;
+    unsigned m_cacheShards;
+    mutable std::mutex m_prefetchLock;
+    mutable std::unique_ptr<PrefetchQueue> m_prefetch;
+
+    std::atomic<bool> m_logging;
+    mutable std::mutex m_logLock;
+    mutable std::ofstream m_accessLog;
+    std::chrono::steady_clock::time_point m_logStart;
+
+    ArchReader(const ArchReader&) = delete;
+    ArchReader& operator=(const ArchReader&) = delete;
+};
@@ -0,0 +1,188 @@
+#include "stdafx.h"
+#include "arch_scanner.h"
+#include "arch_utils.h"
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // FILETIME (100 ns sejak 1601) ke detik Unix, sama seperti FileEntry.timestamp
+    uint64_t FileTimeToUnix(const FILETIME& ft) {
+        uint64_t ticks = (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+        const uint64_t epochDelta = 116444736000000000ull;
+        return ticks > epochDelta ? (ticks - epochDelta) / 10000000ull : 0;
+    }
+
+    struct PendingDir {
+        std::string path;
+        std::string archivePrefix;
+    };
+}
+
+bool ArchScanner::StatFile(const std::string& path, ManifestEntry& item) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data) ||
+        (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        return false;
+    }
+    item.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    item.timestamp = FileTimeToUnix(data.ftLastWriteTime);
+    return true;
+}
+
+void ArchScanner::ScanFolder(const std::string& root,
+    std::vector<ManifestEntry>& manifest,
+    unsigned threadCount) {
+    if (threadCount == 0) {
+        // Enumerasi direktori didominasi latensi (terutama di network share),
+        // jadi thread dibuat lebih banyak dari jumlah core
+        threadCount = std::min(16u, std::max(4u, std::thread::hardware_concurrency() * 2));
+    }
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<PendingDir> pending;
+    unsigned busy = 0;
+    std::vector<ManifestEntry> found;
+    std::string rootError;
+    // Exception di thread scan tidak boleh lolos dari fungsi thread
+    // (std::terminate); yang pertama disimpan dan dilempar ulang setelah join
+    std::exception_ptr failure;
+
+    pending.push_back({ root, "" });
+
+    auto worker = [&]() {
+        std::vector<ManifestEntry> local;
+        std::vector<PendingDir> subdirs;
+
+        while (true) {
+            PendingDir dir;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [&]() { return !pending.empty() || busy == 0; });
+                if (pending.empty()) {
+                    break;
+                }
+                dir = std::move(pending.front());
+                pending.pop_front();
+                busy++;
+            }
+
+            std::exception_ptr error;
+            HANDLE find = INVALID_HANDLE_VALUE;
+            try {
+                WIN32_FIND_DATAA data;
+                std::string pattern = (fs::path(dir.path) / "*").string();
+                find = FindFirstFileExA(pattern.c_str(), FindExInfoBasic, &data,
+                    FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+
+                if (find == INVALID_HANDLE_VALUE) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (dir.archivePrefix.empty()) {
+                        rootError = "Error memproses folder " + dir.path + ": " + ArchUtils::GetLastErrorString();
+                    }
+                    else {
+                        std::cerr << "Warning: Tidak bisa membaca folder: " << dir.path << std::endl;
+                    }
+                }
+                else {
+                    do {
+                        const char* name = data.cFileName;
+                        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+                            continue;
+                        }
+
+                        std::string fullPath = (fs::path(dir.path) / name).string();
+                        std::string archivePath = dir.archivePrefix + name;
+
+                        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                            // Junction/symlink direktori tidak diikuti agar tidak berputar
+                            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+                                subdirs.push_back({ fullPath, archivePath + "/" });
+                            }
+                            continue;
+                        }
+
+                        if (archivePath.length() >= ArchConstants::MAX_FILENAME_LENGTH) {
+                            std::lock_guard<std::mutex> guard(lock);
+                            std::cerr << "Warning: Path terlalu panjang, file akan dilewati: "
+                                << fullPath << std::endl;
+                            continue;
+                        }
+
+                        ManifestEntry item;
+                        item.sourcePath = std::move(fullPath);
+                        item.archivePath = std::move(archivePath);
+                        item.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+                        item.timestamp = FileTimeToUnix(data.ftLastWriteTime);
+                        local.push_back(std::move(item));
+                    } while (FindNextFileA(find, &data));
+                }
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            if (find != INVALID_HANDLE_VALUE) {
+                FindClose(find);
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+            if (error && !failure) {
+                failure = error;
+            }
+            // Setelah gagal, sisa antrian dibuang agar semua worker cepat selesai
+            if (failure) {
+                pending.clear();
+            }
+            else {
+                for (auto& subdir : subdirs) {
+                    pending.push_back(std::move(subdir));
+                }
+            }
+            subdirs.clear();
+            busy--;
+            wake.notify_all();
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        try {
+            for (auto& item : local) {
+                found.push_back(std::move(item));
+            }
+        }
+        catch (...) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (!rootError.empty()) {
+        throw std::runtime_error(rootError);
+    }
+
+    // Urutan worker tidak deterministik; urutkan agar archive bisa direproduksi
+    std::sort(found.begin(), found.end(), [](const ManifestEntry& a, const ManifestEntry& b) {
+        return a.archivePath < b.archivePath;
+    });
+
+    manifest.reserve(manifest.size() + found.size());
+    for (auto& item : found) {
+        manifest.push_back(std::move(item));
+    }
+}
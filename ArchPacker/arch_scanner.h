@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "arch_manifest.h"
+
+namespace ArchScanner {
+    // Menelusuri root satu kali secara paralel: setiap worker mengambil satu
+    // direktori dari antrean bersama dan membacanya dengan FindFirstFileEx
+    // (FindExInfoBasic + large fetch), sehingga ukuran dan waktu modifikasi
+    // didapat dari listing direktori tanpa stat per file. Hasilnya ditambahkan
+    // ke manifest dan diurutkan menurut path di dalam archive.
+    void ScanFolder(const std::string& root,
+        std::vector<ManifestEntry>& manifest,
+        unsigned threadCount = 0);
+
+    // Mengisi ukuran dan waktu modifikasi untuk satu file input
+    bool StatFile(const std::string& path, ManifestEntry& item);
+}
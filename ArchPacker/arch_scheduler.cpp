@@ -0,0 +1,237 @@
+#include "stdafx.h"
+#include "arch_scheduler.h"
+
+namespace {
+    // Worker milik scheduler mana thread ini, untuk Submit ke antrian sendiri
+    thread_local const ArchScheduler* t_scheduler = nullptr;
+    thread_local size_t t_worker = SIZE_MAX;
+    // Tugas bersarang (Wait di dalam tugas) tidak dihitung dua kali
+    thread_local unsigned t_depth = 0;
+}
+
+ArchScheduler::ArchScheduler(unsigned workerCount)
+    : m_queued(0), m_stopping(false),
+    m_start(std::chrono::steady_clock::now()) {
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(new Worker());
+    }
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->thread = std::thread(&ArchScheduler::WorkerLoop, this, i);
+    }
+}
+
+ArchScheduler::~ArchScheduler() {
+    m_stopping = true;
+    Notify();
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+void ArchScheduler::Submit(Group& group, std::function<void()> task) {
+    // Dihitung sebelum masuk antrian: worker yang langsung mengambilnya tidak
+    // boleh menurunkan m_queued di bawah nol
+    group.m_pending++;
+    m_queued++;
+    if (t_scheduler == this) {
+        Worker& own = *m_workers[t_worker];
+        std::lock_guard<std::mutex> lock(own.lock);
+        own.tasks.push_back(Task{ std::move(task), &group });
+    }
+    else {
+        std::lock_guard<std::mutex> lock(m_injectLock);
+        m_injected.push_back(Task{ std::move(task), &group });
+    }
+    Notify();
+}
+
+void ArchScheduler::Wait(Group& group) {
+    if (t_scheduler == this) {
+        // Tugas yang dibuat tugas ini ada di belakang antrian sendiri; begitu
+        // belakang antrian bukan milik group, sisanya sedang dikerjakan worker
+        // lain dan cukup ditunggu
+        Worker& own = *m_workers[t_worker];
+        while (group.m_pending > 0) {
+            Task task;
+            {
+                std::lock_guard<std::mutex> lock(own.lock);
+                if (own.tasks.empty() || own.tasks.back().group != &group) {
+                    break;
+                }
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+            }
+            m_queued--;
+            Execute(task, own);
+        }
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        m_wake.wait(lock, [&]() { return group.m_pending == 0; });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(group.m_errorLock);
+        error.swap(group.m_error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ArchScheduler::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    Group group;
+    for (size_t i = 0; i < count; ++i) {
+        Submit(group, [&body, i]() { body(i); });
+    }
+    Wait(group);
+}
+
+void ArchScheduler::WorkerLoop(size_t index) {
+    t_scheduler = this;
+    t_worker = index;
+    while (true) {
+        if (TryRun(index)) {
+            continue;
+        }
+        if (m_stopping) {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        m_wake.wait(lock, [&]() { return m_queued > 0 || m_stopping; });
+    }
+}
+
+bool ArchScheduler::TryRun(size_t self) {
+    Task task;
+    bool found = false;
+    bool stolen = false;
+    Worker& own = *m_workers[self];
+    {
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+    if (!found) {
+        std::lock_guard<std::mutex> lock(m_injectLock);
+        if (!m_injected.empty()) {
+            task = std::move(m_injected.front());
+            m_injected.pop_front();
+            found = true;
+        }
+    }
+
+    // Curian diambil dari depan: tugas tertua, biasanya yang terbesar
+    size_t count = m_workers.size();
+    for (size_t k = 1; !found && k < count; ++k) {
+        Worker& victim = *m_workers[(self + k) % count];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = stolen = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    m_queued--;
+    if (stolen) {
+        own.stolen++;
+    }
+    Execute(task, own);
+    return true;
+}
+
+void ArchScheduler::Execute(Task& task, Worker& worker) {
+    auto start = std::chrono::steady_clock::now();
+    t_depth++;
+    try {
+        task.run();
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(task.group->m_errorLock);
+        if (!task.group->m_error) {
+            task.group->m_error = std::current_exception();
+        }
+    }
+    t_depth--;
+
+    if (t_depth == 0) {
+        worker.busyMicros += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    worker.executed++;
+
+    // Setelah pending mencapai 0 group boleh langsung dihancurkan penunggunya
+    if (--task.group->m_pending == 0) {
+        Notify();
+    }
+}
+
+void ArchScheduler::Notify() {
+    // Kunci sebentar agar notifikasi tidak hilang di antara cek predikat dan wait
+    {
+        std::lock_guard<std::mutex> lock(m_sleepLock);
+    }
+    m_wake.notify_all();
+}
+
+void ArchScheduler::Report(std::ostream& out, const char* title) const {
+    double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_start).count());
+    uint32_t executed = 0;
+    uint32_t stolen = 0;
+    std::string utilization;
+    for (const auto& worker : m_workers) {
+        char percent[16];
+        snprintf(percent, sizeof(percent), " %.0f%%",
+            elapsed > 0 ? 100.0 * worker->busyMicros / elapsed : 0.0);
+        utilization += percent;
+        executed += worker->executed;
+        stolen += worker->stolen;
+    }
+
+    out << "Scheduler " << title << ": " << m_workers.size() << " worker, utilisasi"
+        << utilization << ", " << executed << " tugas, " << stolen << " dicuri\n";
+}
+
+bool ArchMemoryBudget::TryAcquire(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (!Fits(bytes)) {
+        m_waits++;
+        return false;
+    }
+    Take(bytes);
+    return true;
+}
+
+void ArchMemoryBudget::Acquire(uint64_t bytes) {
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (!Fits(bytes)) {
+        m_waits++;
+        m_released.wait(lock, [&]() { return Fits(bytes); });
+    }
+    Take(bytes);
+}
+
+void ArchMemoryBudget::Release(uint64_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_used -= std::min(bytes, m_used);
+    }
+    m_released.notify_all();
+}
+
+void ArchMemoryBudget::Take(uint64_t bytes) {
+    m_used += bytes;
+    m_peak = std::max(m_peak, m_used);
+}
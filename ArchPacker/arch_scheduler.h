@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+// Thread pool work-stealing untuk pack dan ekstrak. Tugas dari thread luar
+// (batch file dari thread utama) masuk ke satu antrian bersama dan diambil
+// FIFO, jadi urutan Submit tetap menjadi urutan kerja. Tugas yang dibuat worker
+// (mis. potongan kompresi dari satu file besar) masuk ke antrian worker itu dan
+// diambil LIFO, sedangkan worker yang menganggur mencurinya dari depan.
+// Worker yang menunggu Group hanya menjalankan tugas Group itu dari antriannya
+// sendiri, jadi Wait aman dipanggil dari dalam tugas tanpa ikut mengerjakan
+// batch lain; thread luar hanya menunggu.
+class ArchScheduler {
+public:
+    // Sekumpulan tugas yang ditunggu bersama; exception pertama dari tugasnya
+    // dilempar ulang oleh Wait. Tidak boleh dipindah selama masih ada tugas.
+    class Group {
+    public:
+        Group() : m_pending(0) {}
+
+    private:
+        friend class ArchScheduler;
+        std::atomic<size_t> m_pending;
+        std::mutex m_errorLock;
+        std::exception_ptr m_error;
+    };
+
+    // workerCount 0 = satu worker per core
+    explicit ArchScheduler(unsigned workerCount = 0);
+    // Menunggu semua tugas yang sudah di-Submit selesai
+    ~ArchScheduler();
+
+    unsigned GetWorkerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+    void Submit(Group& group, std::function<void()> task);
+    void Wait(Group& group);
+    // body(i) untuk 0 <= i < count sebagai tugas terpisah, lalu Wait
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    // Utilisasi setiap worker (waktu sibuk / waktu sejak scheduler dibuat),
+    // jumlah tugas dan curian, mis. untuk ringkasan di akhir pack atau ekstrak
+    void Report(std::ostream& out, const char* title) const;
+
+private:
+    struct Task {
+        std::function<void()> run;
+        Group* group;
+    };
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+        std::thread thread;
+        std::atomic<uint64_t> busyMicros{ 0 };
+        std::atomic<uint32_t> executed{ 0 };
+        std::atomic<uint32_t> stolen{ 0 };
+    };
+
+    void WorkerLoop(size_t index);
+    // Mengambil tugas dari antrian sendiri, antrian bersama, lalu mencuri dari
+    // worker lain; false jika semua antrian kosong
+    bool TryRun(size_t self);
+    void Execute(Task& task, Worker& worker);
+    void Notify();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::mutex m_injectLock;
+    std::deque<Task> m_injected;
+    std::atomic<size_t> m_queued;
+    std::mutex m_sleepLock;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_stopping;
+    std::chrono::steady_clock::time_point m_start;
+
+    ArchScheduler(const ArchScheduler&) = delete;
+    ArchScheduler& operator=(const ArchScheduler&) = delete;
+};
+
+// Anggaran byte untuk buffer yang sedang diproses pipeline (buffer baca, blob
+// yang menunggu penulis, isi entry hasil decode). Permintaan yang lebih besar
+// dari seluruh anggaran tetap diberikan jika tidak ada byte lain yang terpakai,
+// agar satu file besar tidak macet selamanya.
+class ArchMemoryBudget {
+public:
+    // limit 0 = tanpa batas
+    explicit ArchMemoryBudget(uint64_t limit = 0) : m_limit(limit), m_used(0), m_peak(0), m_waits(0) {}
+
+    // false (tanpa menunggu) jika bytes belum muat; untuk producer yang juga
+    // bertugas membebaskan, mis. penulis pack yang harus menulis dulu
+    bool TryAcquire(uint64_t bytes);
+    // Memblokir sampai bytes muat; byte hanya boleh dibebaskan thread lain
+    void Acquire(uint64_t bytes);
+    void Release(uint64_t bytes);
+
+    uint64_t GetLimit() const { return m_limit; }
+    uint64_t GetPeak() const { return m_peak; }
+    // Berapa kali producer tertahan karena anggaran penuh
+    uint32_t GetWaitCount() const { return m_waits; }
+
+private:
+    bool Fits(uint64_t bytes) const { return m_limit == 0 || m_used == 0 || m_used + bytes <= m_limit; }
+    void Take(uint64_t bytes);
+
+    const uint64_t m_limit;
+    uint64_t m_used;
+    uint64_t m_peak;
+    uint32_t m_waits;
+    std::mutex m_lock;
+    std::condition_variable m_released;
+
+    ArchMemoryBudget(const ArchMemoryBudget&) = delete;
+    ArchMemoryBudget& operator=(const ArchMemoryBudget&) = delete;
+};
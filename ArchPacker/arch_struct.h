@@ -9,16 +9,59 @@ struct ArchHeader {
     uint32_t fileCount;     // 4 byte (total 12)
     uint32_t indexOffset;   // 4 byte (total 16)
     uint32_t flags;         // 4 byte (total 20)
-    uint8_t reserved[44];   // 44 byte (total 64)
+    uint32_t blockSize;     // 4 byte (total 24)
+    uint32_t indexChecksum; // 4 byte (total 28)
+    uint32_t headerChecksum;// 4 byte (total 32)
+    uint32_t volumeCount;   // 4 byte (total 36)
+    uint32_t volumeSetId;   // 4 byte (total 40)
+    uint8_t reserved[24];   // 24 byte (total 64)
 
     ArchHeader() :
         magic(ArchConstants::MAGIC),
         version(ArchConstants::VERSION),
         fileCount(0),
         indexOffset(0),
-        flags(0) {
+        flags(0),
+        blockSize(0),
+        indexChecksum(0),
+        headerChecksum(0),
+        volumeCount(0),
+        volumeSetId(0) {
         memset(reserved, 0, sizeof(reserved));
     }
+
+    // CRC32 seluruh header dengan headerChecksum dianggap 0
+    uint32_t ComputeChecksum() const {
+        ArchHeader copy = *this;
+        copy.headerChecksum = 0;
+        return crc32(0, reinterpret_cast<const Bytef*>(&copy), sizeof(copy));
+    }
+
+    // Header ditulis sekali tanpa di-patch; fileCount/indexOffset ada di ArchFooter
+    static constexpr uint32_t FLAG_STREAMED = 0x1;
+    // Setiap blob diawali LocalEntryHeader, diakhiri LOCAL_END_MAGIC sebelum index
+    static constexpr uint32_t FLAG_LOCAL_HEADERS = 0x2;
+    // headerChecksum, indexChecksum (di footer untuk layout streaming) dan
+    // blockSize terisi; entry dengan FLAG_BLOCK_CHECKSUMS punya tabel CRC blok
+    static constexpr uint32_t FLAG_CHECKSUMS = 0x4;
+    // Blob tersebar di volumeCount file: volume 0 adalah file ini (header dan
+    // index), volume berikutnya <archive>.001 dst. yang diawali VolumeHeader
+    static constexpr uint32_t FLAG_VOLUMES = 0x8;
+};
+
+// Penutup archive layout streaming, selalu 16 byte terakhir file
+struct ArchFooter {
+    uint32_t magic;         // 4 byte
+    uint32_t fileCount;     // 4 byte (total 8)
+    uint32_t indexOffset;   // 4 byte (total 12)
+    uint32_t indexChecksum; // 4 byte (total 16)
+
+    ArchFooter() :
+        magic(ArchConstants::FOOTER_MAGIC),
+        fileCount(0),
+        indexOffset(0),
+        indexChecksum(0) {
+    }
 };
 
 struct FileEntry {
@@ -29,18 +72,80 @@ struct FileEntry {
     uint32_t checksum;      // 4 byte (total 276)
     uint32_t flags;         // 4 byte (total 280)
     uint64_t timestamp;     // 8 byte (total 288)
-    uint8_t compressionType;// 1 byte (total 289)
+    uint8_t compressionType;// 1 byte (total 289) 1 = deflate, 2 = deflate berpotongan
     uint8_t encryptionType; // 1 byte (total 290)
     uint16_t nameFlags;     // 2 byte (total 292) 
 
 
     static constexpr uint32_t FLAG_HAS_ORIGINAL_NAME = 0x1;
     static constexpr uint32_t FLAG_NAME_IS_GARBLED = 0x2; 
+    // Blob diikuti tabel CRC32 per blok (uint32 per header.blockSize byte
+    // tersimpan), sehingga kerusakan bisa dilokalisasi tanpa inflate
+    static constexpr uint32_t FLAG_BLOCK_CHECKSUMS = 0x4;
+    // Penanda hapus untuk archive patch: tanpa blob, menyembunyikan entry
+    // bernama sama dari layer di bawahnya (lihat ArchOverlay)
+    static constexpr uint32_t FLAG_TOMBSTONE = 0x8;
+    // Isi entry (size/checksum) adalah DeltaHeader + operasi COPY/ADD terhadap
+    // entry bernama sama di archive base; lihat ArchDelta
+    static constexpr uint32_t FLAG_DELTA = 0x10;
+    // 8 bit teratas flags: nomor volume tempat blob berada; offset relatif
+    // terhadap awal file volume tersebut
+    static constexpr uint32_t VOLUME_SHIFT = 24;
+    static constexpr uint32_t MAX_VOLUMES = 256;
+
+    uint32_t Volume() const { return flags >> VOLUME_SHIFT; }
+};
+
+// Awal setiap file volume selain volume 0
+struct VolumeHeader {
+    uint32_t magic;         // 4 byte
+    uint32_t volumeSetId;   // 4 byte (total 8), sama dengan ArchHeader
+    uint32_t volume;        // 4 byte (total 12)
+    uint32_t reserved;      // 4 byte (total 16)
+};
+
+// Awal payload entry FLAG_DELTA. Ukuran dan checksum base dipakai untuk
+// memastikan delta diterapkan ke versi yang benar.
+struct DeltaHeader {
+    uint32_t magic;         // 4 byte
+    uint32_t baseSize;      // 4 byte (total 8)
+    uint32_t baseChecksum;  // 4 byte (total 12)
+    uint32_t targetSize;    // 4 byte (total 16)
+    uint32_t targetChecksum;// 4 byte (total 20)
+};
+
+// Awal payload compressionType 2: data asli dipotong per chunkSize byte dan
+// setiap potongan dikompresi sebagai stream zlib sendiri. Diikuti chunkCount
+// uint32 ukuran terkompresi setiap potongan, lalu stream-stream tersebut.
+struct ChunkTableHeader {
+    uint32_t magic;         // 4 byte
+    uint32_t chunkSize;     // 4 byte (total 8)
+    uint32_t chunkCount;    // 4 byte (total 12)
+};
+
+// Salinan entry index tepat sebelum blob-nya, untuk pembaca forward-only
+struct LocalEntryHeader {
+    uint32_t magic;         // 4 byte
+    FileEntry entry;        // 292 byte (total 296)
+
+    LocalEntryHeader() : magic(ArchConstants::LOCAL_MAGIC) {
+        memset(&entry, 0, sizeof(entry));
+    }
 };
 
 static_assert(sizeof(ArchHeader) == ArchConstants::HEADER_SIZE,
     "ArchHeader size mismatch (harus tepat 64 byte)");
+static_assert(sizeof(ArchFooter) == 16,
+    "ArchFooter size mismatch (harus tepat 16 byte)");
 static_assert(sizeof(FileEntry) == 292,
     "FileEntry size mismatch (harus tepat 300 byte)");
+static_assert(sizeof(VolumeHeader) == 16,
+    "VolumeHeader size mismatch (harus tepat 16 byte)");
+static_assert(sizeof(DeltaHeader) == 20,
+    "DeltaHeader size mismatch (harus tepat 20 byte)");
+static_assert(sizeof(ChunkTableHeader) == 12,
+    "ChunkTableHeader size mismatch (harus tepat 12 byte)");
+static_assert(sizeof(LocalEntryHeader) == 296,
+    "LocalEntryHeader size mismatch (harus tepat 296 byte)");
 
 #pragma pack(pop)
\ No newline at end of file
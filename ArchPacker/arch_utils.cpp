@@ -1,5 +1,9 @@
 #include "stdafx.h"
 #include "arch_utils.h"
+#include "arch_struct.h"
+#include "arch_scheduler.h"
+#include <atomic>
+#include <mutex>
 
 uint32_t ArchUtils::CalculateChecksum(const std::string& filename) {
     std::ifstream file(filename, std::ios::binary);
@@ -13,33 +17,99 @@ uint32_t ArchUtils::CalculateChecksum(const std::string& filename) {
     return checksum;
 }
 
-void ArchUtils::CompressData(const std::vector<uint8_t>& input, std::vector<uint8_t>& output) {
-    z_stream zs = { 0 };
-    if (deflateInit(&zs, Z_BEST_COMPRESSION) != Z_OK) {
-        throw std::runtime_error("deflateInit failed: " + GetLastErrorString());
+namespace {
+    // body(i) untuk setiap potongan: sebagai tugas di scheduler jika ada
+    // (worker lain bisa mencurinya), atau berurutan di thread pemanggil. Tanpa
+    // scheduler tidak ada thread baru, karena pemanggilnya (prefetch, mount,
+    // C API) sudah membaca dari banyak thread sekaligus.
+    // body tidak boleh melempar exception.
+    void ForEachChunk(size_t count, const std::function<void(size_t)>& body, ArchScheduler* scheduler) {
+        if (scheduler) {
+            scheduler->ParallelFor(count, body);
+            return;
+        }
+        for (size_t index = 0; index < count; ++index) {
+            body(index);
+        }
     }
 
-    zs.next_in = const_cast<Bytef*>(input.data());
-    zs.avail_in = static_cast<uInt>(input.size());
+    // Satu stream zlib utuh; output dialokasikan sekali sebesar deflateBound
+    void DeflateBuffer(const uint8_t* data, size_t size, std::vector<uint8_t>& output, int level) {
+        z_stream zs = { 0 };
+        if (deflateInit(&zs, level) != Z_OK) {
+            throw std::runtime_error("deflateInit failed: " + ArchUtils::GetLastErrorString());
+        }
 
-    int ret;
-    char buffer[32768];
+        output.resize(deflateBound(&zs, static_cast<uLong>(size)));
+        zs.next_in = const_cast<Bytef*>(data);
+        zs.avail_in = static_cast<uInt>(size);
+        zs.next_out = output.data();
+        zs.avail_out = static_cast<uInt>(output.size());
 
-    do {
-        zs.next_out = reinterpret_cast<Bytef*>(buffer);
-        zs.avail_out = sizeof(buffer);
+        int ret = deflate(&zs, Z_FINISH);
+        output.resize(zs.total_out);
+        deflateEnd(&zs);
 
-        ret = deflate(&zs, Z_FINISH);
-        if (output.size() < zs.total_out) {
-            output.insert(output.end(), buffer, buffer + (zs.total_out - output.size()));
+        if (ret != Z_STREAM_END) {
+            throw std::runtime_error("Compression failed: " + std::to_string(ret));
         }
-    } while (ret == Z_OK);
+    }
+}
 
-    deflateEnd(&zs);
+uint8_t ArchUtils::CompressData(const std::vector<uint8_t>& input, std::vector<uint8_t>& output,
+    int level, ArchScheduler* scheduler) {
+    const size_t chunkSize = ArchConstants::COMPRESS_CHUNK_SIZE;
+    if (input.size() <= chunkSize) {
+        DeflateBuffer(input.data(), input.size(), output, level);
+        return 1;
+    }
 
-    if (ret != Z_STREAM_END) {
-        throw std::runtime_error("Compression failed: " + std::to_string(ret));
+    // Potongan tidak berbagi dictionary, jadi bisa dikompresi (dan nanti
+    // di-inflate) terpisah; rasio turun sedikit di setiap batas potongan
+    size_t chunkCount = (input.size() + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<uint8_t>> chunks(chunkCount);
+    std::mutex failureLock;
+    std::exception_ptr failure;
+
+    ForEachChunk(chunkCount, [&](size_t index) {
+        try {
+            size_t begin = index * chunkSize;
+            DeflateBuffer(input.data() + begin, std::min(chunkSize, input.size() - begin),
+                chunks[index], level);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(failureLock);
+            if (!failure) failure = std::current_exception();
+        }
+    }, scheduler);
+    if (failure) {
+        std::rethrow_exception(failure);
     }
+
+    ChunkTableHeader header;
+    header.magic = ArchConstants::CHUNK_MAGIC;
+    header.chunkSize = static_cast<uint32_t>(chunkSize);
+    header.chunkCount = static_cast<uint32_t>(chunkCount);
+
+    size_t total = sizeof(header) + chunkCount * sizeof(uint32_t);
+    for (const auto& chunk : chunks) {
+        total += chunk.size();
+    }
+    output.resize(total);
+    uint8_t* p = output.data();
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    for (const auto& chunk : chunks) {
+        uint32_t size = static_cast<uint32_t>(chunk.size());
+        memcpy(p, &size, sizeof(size));
+        p += sizeof(size);
+    }
+    for (auto& chunk : chunks) {
+        memcpy(p, chunk.data(), chunk.size());
+        p += chunk.size();
+        std::vector<uint8_t>().swap(chunk);
+    }
+    return 2;
 }
 
 std::string ArchUtils::GetLastErrorString() {
@@ -64,25 +134,121 @@ bool IsValidFilename(const std::string& filename) {
     const char invalidChars[] = "<>:\"/\\|?*";
     return filename.find_first_of(invalidChars) == std::string::npos;
 }
+namespace {
+    // Satu z_stream per thread, dipakai ulang lewat inflateReset. inflateInit
+    // mengalokasikan state dan window 32 KB setiap kali, terasa untuk entry
+    // kecil yang dibaca dari banyak thread sekaligus.
+    struct InflateContext {
+        z_stream zs;
+        bool ready;
+        std::vector<uint8_t> inBuffer;
+        std::vector<uint8_t> outBuffer;
+
+        InflateContext() : ready(false), inBuffer(65536), outBuffer(65536) {
+            memset(&zs, 0, sizeof(zs));
+            ready = inflateInit(&zs) == Z_OK;
+        }
+        ~InflateContext() {
+            if (ready) inflateEnd(&zs);
+        }
+    };
+
+    z_stream* AcquireInflate(InflateContext*& context) {
+        thread_local InflateContext local;
+        context = &local;
+        if (!local.ready || inflateReset(&local.zs) != Z_OK) {
+            return nullptr;
+        }
+        return &local.zs;
+    }
+
+    // Payload deflate biasa tidak pernah cocok: byte pertama stream zlib
+    // selalu bermetode 8 (mis. 'x'), sedangkan magic diawali 'A'
+    bool IsChunked(const uint8_t* data, size_t size) {
+        uint32_t magic;
+        if (size < sizeof(ChunkTableHeader)) {
+            return false;
+        }
+        memcpy(&magic, data, sizeof(magic));
+        return magic == ArchConstants::CHUNK_MAGIC;
+    }
+
+    // Setiap worker meng-inflate potongannya langsung ke rentang output
+    // miliknya sendiri, jadi tidak ada penyalinan atau penguncian per potongan
+    bool InflateChunks(const uint8_t* data, size_t size, uint8_t* output, uint32_t originalSize,
+        ArchScheduler* scheduler) {
+        ChunkTableHeader header;
+        memcpy(&header, data, sizeof(header));
+        uint64_t tableEnd = sizeof(header) + static_cast<uint64_t>(header.chunkCount) * sizeof(uint32_t);
+        if (header.chunkSize == 0 || tableEnd > size ||
+            header.chunkCount != (static_cast<uint64_t>(originalSize) + header.chunkSize - 1) / header.chunkSize) {
+            return false;
+        }
+
+        // Offset setiap potongan di payload dari prefix sum tabel ukuran
+        std::vector<uint64_t> inputOffset(header.chunkCount + 1, tableEnd);
+        for (uint32_t i = 0; i < header.chunkCount; ++i) {
+            uint32_t compressed;
+            memcpy(&compressed, data + sizeof(header) + i * sizeof(uint32_t), sizeof(compressed));
+            inputOffset[i + 1] = inputOffset[i] + compressed;
+        }
+        if (inputOffset.back() != size) {
+            return false;
+        }
+
+        std::atomic<bool> failed(false);
+        ForEachChunk(header.chunkCount, [&](size_t index) {
+            if (failed) {
+                return;
+            }
+            InflateContext* context;
+            z_stream* zs = AcquireInflate(context);
+            uint64_t begin = static_cast<uint64_t>(index) * header.chunkSize;
+            if (zs) {
+                zs->next_in = const_cast<Bytef*>(data + inputOffset[index]);
+                zs->avail_in = static_cast<uInt>(inputOffset[index + 1] - inputOffset[index]);
+                zs->next_out = output + begin;
+                zs->avail_out = static_cast<uInt>(std::min<uint64_t>(header.chunkSize, originalSize - begin));
+            }
+            if (!zs || inflate(zs, Z_FINISH) != Z_STREAM_END || zs->avail_out != 0 || zs->avail_in != 0) {
+                failed = true;
+            }
+        }, scheduler);
+        return !failed;
+    }
+}
+
 bool ArchUtils::DecompressData(const std::vector<char>& input,
     std::vector<char>& output,
     uint32_t originalSize) {
-    z_stream zs;
-    memset(&zs, 0, sizeof(zs));
+    output.resize(originalSize);
+    return DecompressData(reinterpret_cast<const uint8_t*>(input.data()), input.size(),
+        reinterpret_cast<uint8_t*>(output.data()), originalSize);
+}
 
-    if (inflateInit(&zs) != Z_OK) {
-        return false;
+bool ArchUtils::DecompressData(const uint8_t* input, size_t inputSize,
+    uint8_t* output, uint32_t originalSize, ArchScheduler* scheduler) {
+    if (IsChunked(input, inputSize)) {
+        if (!InflateChunks(input, inputSize, output, originalSize, scheduler)) {
+            std::cerr << "Error decompression: tabel potongan tidak valid atau data rusak\n";
+            return false;
+        }
+        return true;
     }
 
-    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
-    zs.avail_in = static_cast<uInt>(input.size());
+    InflateContext* context;
+    z_stream* stream = AcquireInflate(context);
+    if (!stream) {
+        return false;
+    }
+    z_stream& zs = *stream;
 
-    output.resize(originalSize);
-    zs.next_out = reinterpret_cast<Bytef*>(output.data());
+    zs.next_in = const_cast<Bytef*>(input);
+    zs.avail_in = static_cast<uInt>(inputSize);
+    zs.next_out = output;
     zs.avail_out = originalSize;
 
     int ret = inflate(&zs, Z_FINISH);
-    inflateEnd(&zs);
 
     if (ret != Z_STREAM_END) {
         std::cerr << "Error decompression: " << zError(ret)
@@ -91,4 +257,420 @@ bool ArchUtils::DecompressData(const std::vector<char>& input,
     }
 
     return true;
-}
\ No newline at end of file
+}
+bool ArchUtils::DecompressStream(const std::function<size_t(uint8_t*, size_t)>& source,
+    const std::function<void(const uint8_t*, size_t)>& sink) {
+    InflateContext* context;
+    z_stream* stream = AcquireInflate(context);
+    if (!stream) {
+        return false;
+    }
+    z_stream& zs = *stream;
+    std::vector<uint8_t>& inBuffer = context->inBuffer;
+    std::vector<uint8_t>& outBuffer = context->outBuffer;
+    int ret = Z_OK;
+
+    auto refill = [&]() {
+        size_t got = source(inBuffer.data(), inBuffer.size());
+        zs.next_in = inBuffer.data();
+        zs.avail_in = static_cast<uInt>(got);
+        return got > 0;
+    };
+
+    // Payload berpotongan: lewati header dan tabel ukuran, lalu inflate
+    // stream-stream zlib yang bersambung satu per satu
+    uint32_t streams = 1;
+    if (refill() && IsChunked(zs.next_in, zs.avail_in)) {
+        ChunkTableHeader header;
+        memcpy(&header, zs.next_in, sizeof(header));
+        streams = header.chunkCount;
+        uint64_t skip = sizeof(header) + static_cast<uint64_t>(header.chunkCount) * sizeof(uint32_t);
+        while (skip > 0) {
+            if (zs.avail_in == 0 && !refill()) {
+                break;
+            }
+            uInt count = static_cast<uInt>(std::min<uint64_t>(skip, zs.avail_in));
+            zs.next_in += count;
+            zs.avail_in -= count;
+            skip -= count;
+        }
+    }
+
+    for (uint32_t done = 0; done < streams; ++done) {
+        if (done > 0 && inflateReset(&zs) != Z_OK) {
+            ret = Z_STREAM_ERROR;
+            break;
+        }
+        ret = Z_OK;
+        while (ret != Z_STREAM_END) {
+            if (zs.avail_in == 0 && !refill()) {
+                break;
+            }
+
+            zs.next_out = outBuffer.data();
+            zs.avail_out = static_cast<uInt>(outBuffer.size());
+            ret = inflate(&zs, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_STREAM_END) {
+                break;
+            }
+            sink(outBuffer.data(), outBuffer.size() - zs.avail_out);
+        }
+        if (ret != Z_STREAM_END) {
+            break;
+        }
+    }
+
+    if (ret != Z_STREAM_END) {
+        std::cerr << "Error decompression: " << zError(ret)
+            << " (" << ret << ")\n";
+        return false;
+    }
+    return true;
+}
+
+void ArchUtils::UpdateBlockChecksums(std::vector<uint32_t>& table, uint64_t position,
+    const uint8_t* data, size_t size, uint32_t blockSize) {
+    while (size > 0) {
+        size_t block = static_cast<size_t>(position / blockSize);
+        size_t count = std::min<size_t>(size, blockSize - position % blockSize);
+        if (table.size() <= block) {
+            table.resize(block + 1, 0);
+        }
+        table[block] = crc32(table[block], data, static_cast<uInt>(count));
+        position += count;
+        data += count;
+        size -= count;
+    }
+}
+
+std::string ArchUtils::VolumePath(const std::string& archiveFile, uint32_t volume) {
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), ".%03u", volume);
+    return archiveFile + suffix;
+}
+
+namespace {
+    // Event per thread untuk menunggu I/O pada handle FILE_FLAG_OVERLAPPED;
+    // setiap operasi yang berjalan bersamaan butuh event sendiri
+    HANDLE ThreadIoEvent() {
+        struct Holder {
+            HANDLE event = CreateEventA(NULL, TRUE, FALSE, NULL);
+            ~Holder() {
+                if (event) CloseHandle(event);
+            }
+        };
+        thread_local Holder holder;
+        return holder.event;
+    }
+
+    // Satu transfer posisional yang ditunggu sampai selesai; berlaku untuk
+    // handle sinkron maupun overlapped
+    bool TransferAt(HANDLE file, uint64_t offset, void* buffer, DWORD size, DWORD& transferred, bool write) {
+        OVERLAPPED ov = {};
+        ov.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+        ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        ov.hEvent = ThreadIoEvent();
+
+        transferred = 0;
+        BOOL ok = write ? WriteFile(file, buffer, size, NULL, &ov) : ReadFile(file, buffer, size, NULL, &ov);
+        if (!ok && GetLastError() != ERROR_IO_PENDING) {
+            return false;
+        }
+        return GetOverlappedResult(file, &ov, &transferred, TRUE) != FALSE;
+    }
+}
+
+bool ArchUtils::ReadAt(HANDLE file, uint64_t offset, void* buffer, size_t size, size_t* bytesRead) {
+    size_t total = 0;
+    while (total < size) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - total, 1u << 30));
+        DWORD got = 0;
+        if (!TransferAt(file, offset, static_cast<uint8_t*>(buffer) + total, chunk, got, false)) {
+            if (GetLastError() != ERROR_HANDLE_EOF) {
+                if (bytesRead) *bytesRead = total;
+                return false;
+            }
+            got = 0;
+        }
+        if (got == 0) {
+            break;
+        }
+        total += got;
+        offset += got;
+    }
+    if (bytesRead) *bytesRead = total;
+    return total == size;
+}
+
+bool ArchUtils::WriteAt(HANDLE file, uint64_t offset, const void* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - total, 1u << 30));
+        DWORD written = 0;
+        if (!TransferAt(file, offset, const_cast<uint8_t*>(static_cast<const uint8_t*>(data)) + total,
+            chunk, written, true) || written == 0) {
+            return false;
+        }
+        total += written;
+        offset += written;
+    }
+    return true;
+}
+
+ArchUtils::GlobPattern::GlobPattern(const std::string& pattern) {
+    std::string normalized = pattern;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    m_basenameOnly = normalized.find('/') == std::string::npos;
+
+    size_t i = 0;
+    while (i < normalized.size()) {
+        char c = normalized[i];
+        if (c == '*') {
+            if (i + 1 < normalized.size() && normalized[i + 1] == '*') {
+                i += 2;
+                if (i < normalized.size() && normalized[i] == '/') {
+                    m_tokens.push_back({ TokenType::AnyDirs, "", false });
+                    ++i;
+                }
+                else {
+                    m_tokens.push_back({ TokenType::AnyPath, "", false });
+                }
+            }
+            else {
+                m_tokens.push_back({ TokenType::AnySegment, "", false });
+                ++i;
+            }
+        }
+        else if (c == '?') {
+            m_tokens.push_back({ TokenType::AnyChar, "", false });
+            ++i;
+        }
+        else if (c == '[' && normalized.find(']', i + 1) != std::string::npos) {
+            Token token{ TokenType::CharClass, "", false };
+            ++i;
+            if (normalized[i] == '!' || normalized[i] == '^') {
+                token.negate = true;
+                ++i;
+            }
+            // Disimpan sebagai pasangan (awal, akhir) rentang karakter
+            bool first = true;
+            while (i < normalized.size() && (normalized[i] != ']' || first)) {
+                char lo = normalized[i];
+                char hi = lo;
+                if (i + 2 < normalized.size() && normalized[i + 1] == '-' && normalized[i + 2] != ']') {
+                    hi = normalized[i + 2];
+                    i += 2;
+                }
+                token.text.push_back(lo);
+                token.text.push_back(hi);
+                ++i;
+                first = false;
+            }
+            ++i;
+            m_tokens.push_back(std::move(token));
+        }
+        else {
+            if (m_tokens.empty() || m_tokens.back().type != TokenType::Literal) {
+                m_tokens.push_back({ TokenType::Literal, "", false });
+            }
+            m_tokens.back().text.push_back(c);
+            ++i;
+        }
+    }
+}
+
+bool ArchUtils::GlobPattern::Match(const char* path, size_t length) const {
+    const char* end = path + length;
+    if (m_basenameOnly) {
+        for (const char* p = end; p != path; --p) {
+            if (p[-1] == '/' || p[-1] == '\\') {
+                path = p;
+                break;
+            }
+        }
+    }
+    return MatchFrom(0, path, end);
+}
+
+bool ArchUtils::GlobPattern::MatchFrom(size_t token, const char* s, const char* end) const {
+    for (; token < m_tokens.size(); ++token) {
+        const Token& t = m_tokens[token];
+        switch (t.type) {
+        case TokenType::Literal:
+            if (static_cast<size_t>(end - s) < t.text.size() ||
+                memcmp(s, t.text.data(), t.text.size()) != 0) {
+                return false;
+            }
+            s += t.text.size();
+            break;
+
+        case TokenType::AnyChar:
+            if (s == end || *s == '/') return false;
+            ++s;
+            break;
+
+        case TokenType::CharClass: {
+            if (s == end || *s == '/') return false;
+            bool found = false;
+            for (size_t r = 0; r + 1 < t.text.size(); r += 2) {
+                if (*s >= t.text[r] && *s <= t.text[r + 1]) {
+                    found = true;
+                    break;
+                }
+            }
+            if (found == t.negate) return false;
+            ++s;
+            break;
+        }
+
+        case TokenType::AnySegment:
+            if (token + 1 == m_tokens.size()) {
+                return std::find(s, end, '/') == end;
+            }
+            for (const char* p = s; ; ++p) {
+                if (MatchFrom(token + 1, p, end)) return true;
+                if (p == end || *p == '/') return false;
+            }
+
+        case TokenType::AnyPath:
+            if (token + 1 == m_tokens.size()) return true;
+            for (const char* p = s; ; ++p) {
+                if (MatchFrom(token + 1, p, end)) return true;
+                if (p == end) return false;
+            }
+
+        case TokenType::AnyDirs:
+            // "**/" cocok dengan string kosong atau rangkaian "dir/"
+            if (MatchFrom(token + 1, s, end)) return true;
+            for (const char* p = s; p != end; ++p) {
+                if (*p == '/' && MatchFrom(token + 1, p + 1, end)) return true;
+            }
+            return false;
+        }
+    }
+    return s == end;
+}
+
+bool ArchUtils::PathFilter::Matches(const char* path, size_t length) const {
+    bool included = m_include.empty();
+    for (const auto& pattern : m_include) {
+        if (pattern.Match(path, length)) {
+            included = true;
+            break;
+        }
+    }
+    if (!included) return false;
+
+    for (const auto& pattern : m_exclude) {
+        if (pattern.Match(path, length)) return false;
+    }
+    return true;
+}
+
+ArchUtils::MappedFile::MappedFile()
+    : m_file(INVALID_HANDLE_VALUE), m_mapping(NULL), m_view(nullptr), m_size(0) {
+}
+
+ArchUtils::MappedFile::~MappedFile() {
+    Close();
+}
+
+bool ArchUtils::MappedFile::Open(const std::string& path) {
+    Close();
+
+    // Overlapped agar ReadAt dari banyak thread tidak diserialisasi kernel
+    // pada file object yang sama
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS | FILE_FLAG_OVERLAPPED, NULL);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size)) {
+        Close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+
+    if (m_size > 0) {
+        m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m_mapping == NULL) {
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ArchUtils::MappedFile::Close() {
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    m_size = 0;
+}
+
+const uint8_t* ArchUtils::MappedFile::Map(uint64_t offset, size_t length) {
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    if (!m_mapping || length == 0 || offset + length > m_size) {
+        return nullptr;
+    }
+
+    // Offset view harus kelipatan allocation granularity (biasanya 64 KB)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    uint64_t alignedOffset = offset - (offset % info.dwAllocationGranularity);
+    size_t delta = static_cast<size_t>(offset - alignedOffset);
+
+    m_view = MapViewOfFile(m_mapping, FILE_MAP_READ,
+        static_cast<DWORD>(alignedOffset >> 32),
+        static_cast<DWORD>(alignedOffset & 0xFFFFFFFF),
+        length + delta);
+    if (!m_view) {
+        return nullptr;
+    }
+    return static_cast<const uint8_t*>(m_view) + delta;
+}
+
+bool ArchUtils::MappedFile::Prefetch(uint64_t offset, uint64_t length) const {
+    if (!m_mapping || length == 0 || offset >= m_size) {
+        return false;
+    }
+    length = std::min(length, m_size - offset);
+
+    // View sementara hanya untuk memberi tahu memory manager; halaman yang
+    // sudah dibaca tetap di standby list setelah view dilepas
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    uint64_t alignedOffset = offset - (offset % info.dwAllocationGranularity);
+    uint64_t viewLength = length + (offset - alignedOffset);
+    if (viewLength > SIZE_MAX) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(m_mapping, FILE_MAP_READ,
+        static_cast<DWORD>(alignedOffset >> 32),
+        static_cast<DWORD>(alignedOffset & 0xFFFFFFFF),
+        static_cast<size_t>(viewLength));
+    if (!view) {
+        return false;
+    }
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = view;
+    range.NumberOfBytes = static_cast<SIZE_T>(viewLength);
+    BOOL issued = PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    UnmapViewOfFile(view);
+    return issued != FALSE;
+}
@@ -1,14 +1,157 @@
-
 #pragma once
 #include "stdafx.h"
 
+class ArchScheduler;
+
 namespace ArchUtils {
     uint32_t CalculateChecksum(const std::string& filename);
-    void CompressData(const std::vector<uint8_t>& input, std::vector<uint8_t>& output);
+    // Mengembalikan compressionType hasilnya: 1 untuk satu stream zlib, atau 2
+    // jika input lebih dari COMPRESS_CHUNK_SIZE dan dikompresi berpotongan di
+    // semua core (ChunkTableHeader). Kedua bentuk dibaca DecompressData/Stream.
+    // Potongan dikompresi paralel sebagai tugas di scheduler; tanpa scheduler
+    // berurutan di thread pemanggil.
+    uint8_t CompressData(const std::vector<uint8_t>& input, std::vector<uint8_t>& output,
+        int level = Z_BEST_COMPRESSION, ArchScheduler* scheduler = nullptr);
     std::string GetLastErrorString();
     bool ValidateFilename(const std::string& filename);
     bool DecompressData(const std::vector<char>& input,
         std::vector<char>& output,
         uint32_t originalSize);
+    // Inflate langsung ke output milik pemanggil (originalSize byte). Dengan
+    // scheduler, payload berpotongan di-inflate paralel, setiap potongan ke
+    // rentangnya sendiri.
+    bool DecompressData(const uint8_t* input, size_t inputSize,
+        uint8_t* output, uint32_t originalSize, ArchScheduler* scheduler = nullptr);
+
+    // Inflate bertahap tanpa menampung seluruh output: source mengisi buffer
+    // input (mengembalikan 0 saat habis), sink menerima setiap potongan hasil.
+    // Memakai konteks inflate milik thread pemanggil, jadi source/sink tidak
+    // boleh memanggil DecompressStream lagi di thread yang sama.
+    bool DecompressStream(const std::function<size_t(uint8_t*, size_t)>& source,
+        const std::function<void(const uint8_t*, size_t)>& sink);
+
+    // Checksum yang sama dengan CalculateChecksum, untuk data di memori
+    inline uint32_t UpdateChecksum(uint32_t checksum, const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            checksum = (checksum << 5) + checksum + data[i];
+        }
+        return checksum;
+    }
+
+    // CRC32 per blok atas byte blob yang tersimpan (setelah kompresi dan
+    // enkripsi). position adalah offset data di dalam blob; bisa dipanggil
+    // bertahap dengan potongan berapa pun.
+    inline uint32_t BlockCount(uint64_t storedSize, uint32_t blockSize) {
+        return static_cast<uint32_t>((storedSize + blockSize - 1) / blockSize);
+    }
+    void UpdateBlockChecksums(std::vector<uint32_t>& table, uint64_t position,
+        const uint8_t* data, size_t size, uint32_t blockSize);
+
+    // I/O posisional (setara pread/pwrite) yang menunggu sampai selesai. Tidak
+    // memakai file pointer bersama, jadi aman dipanggil dari banyak thread
+    // sekaligus. Handle sinkron diserialisasi Windows per file object; buka
+    // dengan FILE_FLAG_OVERLAPPED agar transfer dari banyak thread benar-benar paralel.
+    // ReadAt berhenti di EOF; bytesRead berisi jumlah yang benar-benar terbaca.
+    bool ReadAt(HANDLE file, uint64_t offset, void* buffer, size_t size, size_t* bytesRead = nullptr);
+    bool WriteAt(HANDLE file, uint64_t offset, const void* data, size_t size);
+
+    // Nama file volume ke-n (n >= 1) dari archive multi-volume: <archive>.001 dst.
+    std::string VolumePath(const std::string& archiveFile, uint32_t volume);
+
+    // items sudah urut (volume, offset); disusun ulang bergiliran antar volume
+    // (a0 b0 c0 a1 b1 ...) sehingga worker yang mengambil item berurutan
+    // membaca semua volume sekaligus, sementara tiap volume tetap dibaca maju
+    template <typename T, typename VolumeOf>
+    void InterleaveVolumes(std::vector<T>& items, VolumeOf volumeOf) {
+        std::vector<std::vector<T>> byVolume;
+        for (auto& item : items) {
+            uint32_t volume = volumeOf(item);
+            if (volume >= byVolume.size()) {
+                byVolume.resize(volume + 1);
+            }
+            byVolume[volume].push_back(std::move(item));
+        }
+        items.clear();
+        for (size_t round = 0; ; ++round) {
+            bool any = false;
+            for (auto& list : byVolume) {
+                if (round < list.size()) {
+                    items.push_back(std::move(list[round]));
+                    any = true;
+                }
+            }
+            if (!any) {
+                break;
+            }
+        }
+    }
+
+    // Pola glob yang sudah dikompilasi: '*' dan '?' tidak melewati '/',
+    // '**' melewati '/', '[a-z]' / '[!a-z]' untuk kelas karakter.
+    // Pola tanpa '/' dicocokkan ke nama file saja (seperti .gitignore).
+    class GlobPattern {
+    public:
+        GlobPattern() = default;
+        explicit GlobPattern(const std::string& pattern);
+
+        bool Match(const char* path, size_t length) const;
+        bool Match(const std::string& path) const { return Match(path.data(), path.size()); }
+        bool Empty() const { return m_tokens.empty(); }
+
+    private:
+        enum class TokenType : uint8_t { Literal, AnyChar, AnySegment, AnyPath, AnyDirs, CharClass };
+        struct Token {
+            TokenType type;
+            std::string text;
+            bool negate;
+        };
+
+        bool MatchFrom(size_t token, const char* s, const char* end) const;
+
+        std::vector<Token> m_tokens;
+        bool m_basenameOnly = false;
+    };
+
+    // Kombinasi pola --only / --exclude. Tanpa pola include semua path
+    // dianggap cocok; pola exclude selalu menang.
+    class PathFilter {
+    public:
+        void Include(const std::string& pattern) { m_include.emplace_back(pattern); }
+        void Exclude(const std::string& pattern) { m_exclude.emplace_back(pattern); }
+
+        bool Matches(const char* path, size_t length) const;
+        bool Empty() const { return m_include.empty() && m_exclude.empty(); }
+
+    private:
+        std::vector<GlobPattern> m_include;
+        std::vector<GlobPattern> m_exclude;
+    };
+
+    // View read-only ke sebagian file lewat file mapping, sehingga header dan
+    // index bisa dibaca tanpa menyentuh data blob di archive besar.
+    class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        bool Open(const std::string& path);
+        void Close();
+
+        // Mengganti view aktif; pointer lama tidak valid lagi.
+        const uint8_t* Map(uint64_t offset, size_t length);
+        // Meminta OS membaca rentang ke file cache secara asinkron (readahead);
+        // tidak mengubah view aktif, aman dipanggil dari banyak thread.
+        bool Prefetch(uint64_t offset, uint64_t length) const;
+        uint64_t Size() const { return m_size; }
+        HANDLE Handle() const { return m_file; }
+
+    private:
+        HANDLE m_file;
+        HANDLE m_mapping;
+        void* m_view;
+        uint64_t m_size;
 
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+    };
 }
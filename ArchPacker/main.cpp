@@ -1,8 +1,14 @@
 
 #include "stdafx.h"
 #include "arch_packer.h"
+#include "arch_reader.h"
+#include "arch_mount.h"
 #include <filesystem>
 #include <chrono>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
 
 namespace fs = std::filesystem;
 
@@ -14,15 +20,48 @@ void ShowHelp() {
     std::cout << "Options:\n";
     std::cout << "  -c       Aktifkan kompresi (default)\n";
     std::cout << "  -x       Extract Archives\n";
+    std::cout << "  --only <pola>     (dengan -x) Ekstrak hanya path yang cocok\n";
+    std::cout << "  --exclude <pola>  (dengan -x) Lewati path yang cocok\n";
+    std::cout << "  --overlay <patch> (dengan -x) Terapkan archive patch di atas archive (boleh berulang)\n";
+    std::cout << "  -l       Tampilkan isi archive: -l <archive> [pola] [--json]\n";
+    std::cout << "  -t       Uji integritas archive: -t <archive> [-p pw] [--quick]\n";
     std::cout << "  -nc      Nonaktifkan kompresi\n";
     std::cout << "  -e       Aktifkan enkripsi\n";
-    std::cout << "  -p <pw>  Tentukan passphrase untuk enkripsi\n";
+    std::cout << "  -p <pw>  Tentukan passphrase untuk enkripsi (dengan encrypt=yes di policy, hanya file itu)\n";
+    std::cout << "  --stream Layout streaming tanpa seek (otomatis jika output '-')\n";
+    std::cout << "  --local-headers   Tulis header per file agar bisa diekstrak sekuensial\n";
+    std::cout << "  --align <n|.ext=n>      Ratakan offset blob ke kelipatan n (mis. 4096)\n";
+    std::cout << "  --layout-profile <log>  Urutkan blob menurut access log ArchReader\n";
+    std::cout << "  --access-log <log>      (dengan -x, cat, mount) Catat urutan file yang dibaca untuk --layout-profile\n";
+    std::cout << "  --policy <file>   Codec, level, alignment dan enkripsi per pola file (lihat arch_policy.h)\n";
+    std::cout << "  --delete <path>   Tulis tombstone untuk path (archive patch, boleh berulang)\n";
+    std::cout << "  --resume          Lanjutkan pembuatan archive yang terputus dari journal\n";
+    std::cout << "  --base <archive>  Tulis file yang berubah sebagai delta terhadap archive base (boleh berulang)\n";
+    std::cout << "  --volumes <n>     Pecah data archive ke n file volume (.001, .002, ...)\n";
+    std::cout << "  --volume-size <MB>      Mulai volume baru setiap MB data\n";
+    std::cout << "  --volume-dir <folder>   Letak volume di disk lain (boleh berulang; juga untuk -x, -t, -l, cat)\n";
+    std::cout << "  --sequential      (dengan -x) Ekstrak forward-only; otomatis jika archive '-'\n";
+    std::cout << "  --max-memory <MB> Batas buffer yang diproses paralel saat pack dan -x\n";
+    std::cout << "  cat      Tulis satu file ke stdout: cat <archive> <path> [-p pw]\n";
+    std::cout << "  mount    Tampilkan archive sebagai folder read-only (ProjFS): mount <archive> <folder> [-p pw] [--cache MB]\n";
     std::cout << "  -v       Tampilkan versi\n";
     std::cout << "  -h       Tampilkan bantuan ini\n";
     std::cout << "\nContoh:\n";
     std::cout << "  arch_packer game.arch asset/*.png\n";
     std::cout << "  arch_packer -nc data.arch file1.bin file2.dat\n";
+    std::cout << "  arch_packer game.arch assets/ --policy pack.policy\n";
     std::cout << "  arch_packer -e -p \"passwordku\" rahasia.arch dokumen/*\n";
+    std::cout << "  arch_packer -nc - assets/ | gzip > assets.arch.gz\n";
+    std::cout << "  curl -s https://host/assets.arch | arch_packer -x - assets/ --preserve\n";
+    std::cout << "  arch_packer cat game.arch config/server.json > server.json\n";
+    std::cout << "  arch_packer -l game.arch \"textures/**/*.png\"\n";
+    std::cout << "  arch_packer -t game.arch\n";
+    std::cout << "  arch_packer patch1.arch assets/ --delete old/intro.bik\n";
+    std::cout << "  arch_packer -x game.arch --overlay patch1.arch --overlay patch2.arch out/ --preserve\n";
+    std::cout << "  arch_packer patch2.arch assets/ --base game.arch --base patch1.arch\n";
+    std::cout << "  arch_packer game.arch assets/ --volumes 3 --volume-dir D:\\arch --volume-dir E:\\arch\n";
+    std::cout << "  arch_packer game.arch assets/ --max-memory 512\n";
+    std::cout << "  arch_packer mount game.arch C:\\mnt\\game\n";
 }
 void ShowVersion() {
     std::cout << "ArchPacker v1.0 (x86/x32)\n";
@@ -30,12 +69,41 @@ void ShowVersion() {
     std::cout << "Ukuran header: " << sizeof(ArchHeader) << " bytes\n";
 }
 
+namespace {
+    HANDLE g_unmountEvent = NULL;
+
+    BOOL WINAPI OnConsoleCtrl(DWORD) {
+        SetEvent(g_unmountEvent);
+        return TRUE;
+    }
+}
+
+// Opsi pembuatan archive di luar kompresi/enkripsi, diteruskan ke ArchPacker
+struct CreateOptions {
+    bool streamingLayout = false;
+    bool localHeaders = false;
+    std::string layoutProfile;
+    std::string policyFile;
+    // Pasangan (extension, alignment); extension kosong = default
+    std::vector<std::pair<std::string, uint32_t>> alignments;
+    // Path di dalam archive yang ditandai terhapus (tombstone)
+    std::vector<std::string> deletions;
+    // Tumpukan archive base untuk entry delta, base dulu
+    std::vector<std::string> deltaBases;
+    bool resume = false;
+    uint32_t volumeCount = 0;
+    uint64_t volumeSize = 0;
+    std::vector<std::string> volumeDirs;
+    uint64_t maxMemory = 0;
+};
+
 int ProcessCommandLine(int argc, char* argv[],
     std::string& outputFile,
     std::vector<std::string>& inputFiles,
     bool& enableCompression,
     bool& enableEncryption,
-    std::string& passphrase) {
+    std::string& passphrase,
+    CreateOptions& options) {
     if (argc < 2) {
         ShowHelp();
         return 1;
@@ -67,9 +135,109 @@ int ProcessCommandLine(int argc, char* argv[],
                 return 1;
             }
             passphrase = argv[++i];
-            enableEncryption = true;
         }
-        else if (argv[i][0] == '-') {
+        else if (strcmp(argv[i], "--stream") == 0) {
+            options.streamingLayout = true;
+        }
+        else if (strcmp(argv[i], "--local-headers") == 0) {
+            options.localHeaders = true;
+        }
+        else if (strcmp(argv[i], "--align") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Opsi --align membutuhkan ukuran, mis. 4096 atau .dds=4096\n";
+                return 1;
+            }
+            std::string value = argv[++i];
+            std::string extension;
+            size_t eq = value.find('=');
+            if (eq != std::string::npos) {
+                extension = value.substr(0, eq);
+                value = value.substr(eq + 1);
+            }
+            unsigned long alignment = strtoul(value.c_str(), nullptr, 10);
+            if (alignment == 0 || alignment > (1u << 24) || (alignment & (alignment - 1)) != 0) {
+                std::cerr << "Error: Alignment harus pangkat dua antara 1 dan 16 MB: " << value << "\n";
+                return 1;
+            }
+            options.alignments.emplace_back(extension, static_cast<uint32_t>(alignment));
+        }
+        else if (strcmp(argv[i], "--layout-profile") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Opsi --layout-profile membutuhkan file access log\n";
+                return 1;
+            }
+            options.layoutProfile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--policy") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Opsi --policy membutuhkan file policy\n";
+                return 1;
+            }
+            options.policyFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--delete") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Opsi --delete membutuhkan path di dalam archive\n";
+                return 1;
+            }
+            options.deletions.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--resume") == 0) {
+            options.resume = true;
+        }
+        else if (strcmp(argv[i], "--base") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Opsi --base membutuhkan file archive\n";
+                return 1;
+            }
+            options.deltaBases.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--volumes") == 0 || strcmp(argv[i], "--volume-size") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Opsi " << argv[i] << " membutuhkan angka\n";
+                return 1;
+            }
+            bool bySize = strcmp(argv[i], "--volume-size") == 0;
+            unsigned long value = strtoul(argv[++i], nullptr, 10);
+            if (bySize) {
+                if (value == 0 || value > 4095) {
+                    std::cerr << "Error: Ukuran volume harus antara 1 dan 4095 MB\n";
+                    return 1;
+                }
+                options.volumeSize = static_cast<uint64_t>(value) << 20;
+            }
+            else {
+                if (value < 1 || value > FileEntry::MAX_VOLUMES) {
+                    std::cerr << "Error: Jumlah volume harus antara 1 dan " << FileEntry::MAX_VOLUMES << "\n";
+                    return 1;
+                }
+                options.volumeCount = static_cast<uint32_t>(value);
+            }
+            if (options.volumeCount > 0 && options.volumeSize > 0) {
+                std::cerr << "Error: --volumes dan --volume-size tidak bisa digabung\n";
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--volume-dir") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Opsi --volume-dir membutuhkan folder\n";
+                return 1;
+            }
+            options.volumeDirs.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-memory") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Opsi --max-memory membutuhkan ukuran dalam MB\n";
+                return 1;
+            }
+            unsigned long megabytes = strtoul(argv[++i], nullptr, 10);
+            if (megabytes == 0) {
+                std::cerr << "Error: Batas memori harus minimal 1 MB\n";
+                return 1;
+            }
+            options.maxMemory = static_cast<uint64_t>(megabytes) << 20;
+        }
+        else if (argv[i][0] == '-' && argv[i][1] != '\0') {
             std::cerr << "Error: Opsi tidak dikenali '" << argv[i] << "'\n";
             return 1;
         }
@@ -107,7 +275,7 @@ int ProcessCommandLine(int argc, char* argv[],
         return 1;
     }
 
-    if (inputFiles.empty()) {
+    if (inputFiles.empty() && options.deletions.empty()) {
         std::cerr << "Error: Tidak ada file input yang spesifikasikan\n";
         return 1;
     }
@@ -122,10 +290,209 @@ int ProcessCommandLine(int argc, char* argv[],
 
 int main(int argc, char* argv[]) {
     try {
+        if (argc >= 2 && strcmp(argv[1], "cat") == 0) {
+            std::string archiveFile;
+            std::string entryName;
+            std::string passphrase;
+            std::string accessLog;
+            std::vector<std::string> volumeDirs;
+
+            for (int i = 2; i < argc; i++) {
+                if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--volume-dir") == 0 ||
+                    strcmp(argv[i], "--access-log") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi " << argv[i] << " membutuhkan nilai\n";
+                        return 1;
+                    }
+                    if (strcmp(argv[i], "-p") == 0) {
+                        passphrase = argv[++i];
+                    }
+                    else if (strcmp(argv[i], "--access-log") == 0) {
+                        accessLog = argv[++i];
+                    }
+                    else {
+                        volumeDirs.push_back(argv[++i]);
+                    }
+                }
+                else if (archiveFile.empty()) {
+                    archiveFile = argv[i];
+                }
+                else {
+                    entryName = argv[i];
+                }
+            }
+
+            if (archiveFile.empty() || entryName.empty()) {
+                std::cerr << "Error: Mohon spesifikasikan archive dan path file di dalamnya\n";
+                std::cerr << "Contoh: " << argv[0] << " cat archive.arch config/app.json [-p password]\n";
+                return 1;
+            }
+
+            // stdout berisi data file, jadi semua pesan lain harus ke stderr
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            ArchPacker packer;
+            if (!passphrase.empty()) {
+                packer.SetEncryptionKey(passphrase);
+            }
+            packer.SetVolumeDirectories(volumeDirs);
+            packer.SetAccessLog(accessLog);
+            return packer.StreamEntry(archiveFile, entryName, std::cout) ? 0 : 1;
+        }
+
+        if (argc >= 2 && strcmp(argv[1], "-l") == 0) {
+            if (argc < 3) {
+                std::cerr << "Error: Mohon spesifikasikan file archive untuk listing\n";
+                std::cerr << "Contoh: " << argv[0] << " -l archive.arch [pola] [--json]\n";
+                return 1;
+            }
+
+            std::string archiveFile;
+            std::string pattern;
+            bool machineReadable = false;
+            std::vector<std::string> volumeDirs;
+
+            for (int i = 2; i < argc; i++) {
+                if (strcmp(argv[i], "--json") == 0) {
+                    machineReadable = true;
+                }
+                else if (strcmp(argv[i], "--volume-dir") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi --volume-dir membutuhkan folder\n";
+                        return 1;
+                    }
+                    volumeDirs.push_back(argv[++i]);
+                }
+                else if (archiveFile.empty()) {
+                    archiveFile = argv[i];
+                }
+                else {
+                    pattern = argv[i];
+                }
+            }
+
+            if (archiveFile.empty()) {
+                std::cerr << "Error: Nama file archive harus dispesifikasikan\n";
+                return 1;
+            }
+
+            ArchPacker packer;
+            packer.SetVolumeDirectories(volumeDirs);
+            return packer.ListArchive(archiveFile, pattern, machineReadable) ? 0 : 1;
+        }
+
+        if (argc >= 2 && strcmp(argv[1], "-t") == 0) {
+            std::string archiveFile;
+            std::string passphrase;
+            bool quick = false;
+            std::vector<std::string> volumeDirs;
+
+            for (int i = 2; i < argc; i++) {
+                if (strcmp(argv[i], "-p") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi -p membutuhkan passphrase\n";
+                        return 1;
+                    }
+                    passphrase = argv[++i];
+                }
+                else if (strcmp(argv[i], "--volume-dir") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi --volume-dir membutuhkan folder\n";
+                        return 1;
+                    }
+                    volumeDirs.push_back(argv[++i]);
+                }
+                else if (strcmp(argv[i], "--quick") == 0) {
+                    quick = true;
+                }
+                else {
+                    archiveFile = argv[i];
+                }
+            }
+
+            if (archiveFile.empty()) {
+                std::cerr << "Error: Mohon spesifikasikan file archive untuk diuji\n";
+                std::cerr << "Contoh: " << argv[0] << " -t archive.arch [-p password] [--quick]\n";
+                return 1;
+            }
+
+            ArchPacker packer;
+            if (!passphrase.empty()) {
+                packer.SetEncryptionKey(passphrase);
+            }
+            packer.SetVolumeDirectories(volumeDirs);
+            return packer.VerifyFile(archiveFile, quick) ? 0 : 1;
+        }
+
+        if (argc >= 2 && strcmp(argv[1], "mount") == 0) {
+            std::string archiveFile;
+            std::string mountPoint;
+            std::string passphrase;
+            std::string accessLog;
+            long cacheMegabytes = -1;
+
+            for (int i = 2; i < argc; i++) {
+                if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--cache") == 0 ||
+                    strcmp(argv[i], "--access-log") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi " << argv[i] << " membutuhkan nilai\n";
+                        return 1;
+                    }
+                    if (strcmp(argv[i], "-p") == 0) {
+                        passphrase = argv[++i];
+                    }
+                    else if (strcmp(argv[i], "--access-log") == 0) {
+                        accessLog = argv[++i];
+                    }
+                    else {
+                        cacheMegabytes = strtol(argv[++i], nullptr, 10);
+                        if (cacheMegabytes < 0) {
+                            std::cerr << "Error: Ukuran cache tidak valid\n";
+                            return 1;
+                        }
+                    }
+                }
+                else if (archiveFile.empty()) {
+                    archiveFile = argv[i];
+                }
+                else {
+                    mountPoint = argv[i];
+                }
+            }
+
+            if (archiveFile.empty() || mountPoint.empty()) {
+                std::cerr << "Error: Mohon spesifikasikan archive dan folder mount point\n";
+                std::cerr << "Contoh: " << argv[0] << " mount archive.arch C:\\mnt\\archive [-p password] [--cache MB]\n";
+                return 1;
+            }
+
+            ArchMount mount;
+            mount.SetEncryptionKey(passphrase);
+            mount.SetAccessLog(accessLog);
+            if (cacheMegabytes >= 0) {
+                mount.SetCacheBudget(static_cast<size_t>(cacheMegabytes) * 1024 * 1024);
+            }
+            if (!mount.Start(archiveFile, mountPoint)) {
+                std::cerr << "Error: " << mount.GetError() << "\n";
+                return 1;
+            }
+
+            g_unmountEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+            SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+            std::cout << "Archive di-mount di " << mountPoint << ". Tekan Ctrl+C untuk unmount.\n";
+            WaitForSingleObject(g_unmountEvent, INFINITE);
+
+            mount.Stop();
+            CloseHandle(g_unmountEvent);
+            std::cout << "Unmount selesai\n";
+            return 0;
+        }
+
         if (argc >= 2 && strcmp(argv[1], "-x") == 0) {
             if (argc < 3) {
                 std::cerr << "Error: Mohon spesifikasikan file archive untuk extract\n";
-                std::cerr << "Contoh: " << argv[0] << " -x archive.arch [-p password] [output_dir]\n";
+                std::cerr << "Contoh: " << argv[0] << " -x archive.arch [-p password] [--only pola] [--exclude pola] [output_dir]\n";
                 return 1;
             }
 
@@ -134,9 +501,28 @@ int main(int argc, char* argv[]) {
             std::string passphrase;
             bool hasPassphrase = false;
             bool preserveStructure = false;
+            bool sequential = false;
+            ArchUtils::PathFilter filter;
+            std::vector<std::string> overlays;
+            std::vector<std::string> volumeDirs;
+            std::string accessLog;
+            uint64_t maxMemory = 0;
 
             for (int i = 2; i < argc; i++) {
-                if (strcmp(argv[i], "-p") == 0) {
+                if (strcmp(argv[i], "--only") == 0 || strcmp(argv[i], "--exclude") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi " << argv[i] << " membutuhkan pola\n";
+                        return 1;
+                    }
+                    if (strcmp(argv[i], "--only") == 0) {
+                        filter.Include(argv[i + 1]);
+                    }
+                    else {
+                        filter.Exclude(argv[i + 1]);
+                    }
+                    ++i;
+                }
+                else if (strcmp(argv[i], "-p") == 0) {
                     if (i + 1 < argc) {
                         passphrase = argv[++i];
                         hasPassphrase = true;
@@ -146,9 +532,45 @@ int main(int argc, char* argv[]) {
                         return 1;
                     }
                 }
+                else if (strcmp(argv[i], "--overlay") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi --overlay membutuhkan file archive patch\n";
+                        return 1;
+                    }
+                    overlays.push_back(argv[++i]);
+                }
+                else if (strcmp(argv[i], "--volume-dir") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi --volume-dir membutuhkan folder\n";
+                        return 1;
+                    }
+                    volumeDirs.push_back(argv[++i]);
+                }
+                else if (strcmp(argv[i], "--access-log") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi --access-log membutuhkan file log\n";
+                        return 1;
+                    }
+                    accessLog = argv[++i];
+                }
+                else if (strcmp(argv[i], "--max-memory") == 0) {
+                    if (i + 1 >= argc) {
+                        std::cerr << "Error: Opsi --max-memory membutuhkan ukuran dalam MB\n";
+                        return 1;
+                    }
+                    unsigned long megabytes = strtoul(argv[++i], nullptr, 10);
+                    if (megabytes == 0) {
+                        std::cerr << "Error: Batas memori harus minimal 1 MB\n";
+                        return 1;
+                    }
+                    maxMemory = static_cast<uint64_t>(megabytes) << 20;
+                }
                 else if (strcmp(argv[i], "--preserve") == 0) {
                     preserveStructure = true;
                 }
+                else if (strcmp(argv[i], "--sequential") == 0) {
+                    sequential = true;
+                }
                 else if (archiveFile.empty()) {
                     archiveFile = argv[i];
                 }
@@ -165,7 +587,11 @@ int main(int argc, char* argv[]) {
             ArchPacker packer;
             if (hasPassphrase) {
                 packer.SetEncryptionKey(passphrase);
+                ArchCrypto::PrintGeneratedKey(passphrase);
             }
+            packer.SetVolumeDirectories(volumeDirs);
+            packer.SetMaxMemory(maxMemory);
+            packer.SetAccessLog(accessLog);
 
             std::cout << "Memulai ekstraksi archive: " << archiveFile << "\n";
             if (hasPassphrase) {
@@ -175,7 +601,34 @@ int main(int argc, char* argv[]) {
                 std::cout << "Mempertahankan struktur folder\n";
             }
 
-            return packer.ExtractArchive(archiveFile, outputDir, preserveStructure) ? 0 : 1;
+            if (!overlays.empty()) {
+                if (archiveFile == "-" || sequential) {
+                    std::cerr << "Error: --overlay tidak bisa digabung dengan ekstraksi sekuensial\n";
+                    return 1;
+                }
+                std::vector<std::string> layers(1, archiveFile);
+                layers.insert(layers.end(), overlays.begin(), overlays.end());
+                return packer.ExtractOverlay(layers, outputDir, preserveStructure, filter) ? 0 : 1;
+            }
+            if ((archiveFile == "-" || sequential) && !accessLog.empty()) {
+                std::cerr << "Error: --access-log tidak bisa digabung dengan ekstraksi sekuensial\n";
+                return 1;
+            }
+            if (archiveFile == "-") {
+#ifdef _WIN32
+                _setmode(_fileno(stdin), _O_BINARY);
+#endif
+                return packer.ExtractStream(std::cin, outputDir, preserveStructure, filter) ? 0 : 1;
+            }
+            if (sequential) {
+                std::ifstream in(archiveFile, std::ios::binary);
+                if (!in) {
+                    std::cerr << "Error: Gagal membuka file archive: " << archiveFile << "\n";
+                    return 1;
+                }
+                return packer.ExtractStream(in, outputDir, preserveStructure, filter) ? 0 : 1;
+            }
+            return packer.ExtractArchive(archiveFile, outputDir, preserveStructure, filter) ? 0 : 1;
         }
 
         std::string outputFile;
@@ -183,9 +636,10 @@ int main(int argc, char* argv[]) {
         bool enableCompression = true;
         bool enableEncryption = false;
         std::string passphrase;
+        CreateOptions options;
 
         int result = ProcessCommandLine(argc, argv, outputFile, inputFiles,
-            enableCompression, enableEncryption, passphrase);
+            enableCompression, enableEncryption, passphrase, options);
         if (result != -1) {
             return result;
         }
@@ -195,6 +649,37 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        ArchPolicy policy;
+        if (!options.policyFile.empty()) {
+            try {
+                policy.Load(options.policyFile);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                return 1;
+            }
+        }
+        // -p saja mengenkripsi semua file, kecuali policy memilih sendiri file
+        // yang dienkripsi lewat encrypt=yes; -e tetap mengenkripsi semuanya
+        std::string encryptPattern = policy.GetEncryptPattern();
+        if (!encryptPattern.empty() && passphrase.empty()) {
+            std::cerr << "Error: Aturan policy '" << encryptPattern
+                << "' meminta enkripsi tetapi passphrase tidak diberikan (-p)\n";
+            return 1;
+        }
+        if (!passphrase.empty() && encryptPattern.empty()) {
+            enableEncryption = true;
+        }
+
+        // Output '-' berarti archive ditulis ke stdout; pesan pindah ke stderr
+        bool toStdout = outputFile == "-";
+        std::ostream& info = toStdout ? std::cerr : std::cout;
+#ifdef _WIN32
+        if (toStdout) {
+            _setmode(_fileno(stdout), _O_BINARY);
+        }
+#endif
+
         uint64_t totalSize = 0;
         for (const auto& file : inputFiles) {
             try {
@@ -210,15 +695,56 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        std::cout << "Membuat archive '" << outputFile << "' dengan "
+        info << "Membuat archive '" << outputFile << "' dengan "
             << inputFiles.size() << " file ("
             << (totalSize / 1024) << " KB)\n";
-        std::cout << "Kompresi: " << (enableCompression ? "AKTIF" : "NONAKTIF") << "\n";
-        std::cout << "Enkripsi: " << (enableEncryption ? "AKTIF" : "NONAKTIF") << "\n";
+        info << "Kompresi: " << (enableCompression ? "AKTIF" : "NONAKTIF") << "\n";
+        info << "Enkripsi: " << (enableEncryption ? "AKTIF" :
+            passphrase.empty() ? "NONAKTIF" : "SESUAI POLICY") << "\n";
+        if (options.streamingLayout || toStdout) {
+            info << "Layout: STREAMING (footer di akhir archive)\n";
+        }
+        if (options.localHeaders) {
+            info << "Local header: AKTIF\n";
+        }
+        if (!options.deletions.empty()) {
+            info << "Tombstone: " << options.deletions.size() << " path ditandai terhapus\n";
+        }
+        if (!options.deltaBases.empty()) {
+            info << "Delta terhadap: " << options.deltaBases.size() << " archive base\n";
+        }
+        if (!policy.Empty()) {
+            info << "Policy: " << policy.GetRuleCount() << " aturan dari " << options.policyFile << "\n";
+        }
+        if (options.volumeCount > 1 || options.volumeSize > 0) {
+            info << "Multi-volume: " << (options.volumeCount > 1 ?
+                std::to_string(options.volumeCount) + " volume" :
+                std::to_string(options.volumeSize >> 20) + " MB per volume") << "\n";
+        }
+        if (options.maxMemory > 0) {
+            info << "Batas memori: " << (options.maxMemory >> 20) << " MB\n";
+        }
 
         ArchPacker packer;
-        if (enableEncryption) {
-            packer.SetEncryptionKey(passphrase);
+        if (!passphrase.empty()) {
+            packer.SetEncryptionKey(passphrase, enableEncryption);
+            if (!toStdout) {
+                ArchCrypto::PrintGeneratedKey(passphrase);
+            }
+        }
+        packer.SetStreamingLayout(options.streamingLayout);
+        packer.SetLocalHeaders(options.localHeaders);
+        packer.SetLayoutProfile(options.layoutProfile);
+        packer.SetPolicy(policy);
+        packer.SetDeletions(options.deletions);
+        packer.SetDeltaBase(options.deltaBases);
+        packer.SetResume(options.resume);
+        packer.SetVolumeCount(options.volumeCount);
+        packer.SetVolumeSize(options.volumeSize);
+        packer.SetVolumeDirectories(options.volumeDirs);
+        packer.SetMaxMemory(options.maxMemory);
+        for (const auto& alignment : options.alignments) {
+            packer.SetAlignment(alignment.second, alignment.first);
         }
 
         auto startTime = std::chrono::high_resolution_clock::now();
@@ -227,31 +753,57 @@ int main(int argc, char* argv[]) {
             std::cerr << "Gagal membuat archive!\n";
             return 1;
         }
+        // File yang gagal tidak ada di archive; exit code menandai archive tidak lengkap
+        const std::vector<std::string>& failures = packer.GetFailures();
+        for (const auto& failure : failures) {
+            std::cerr << "Error memproses file " << failure << "\n";
+        }
+        int exitCode = failures.empty() ? 0 : 1;
 
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
+        if (toStdout) {
+            info << "\nArchive berhasil ditulis ke stdout dalam " << duration.count() << " ms\n";
+            if (packer.GetPaddingBytes() > 0) {
+                info << "Padding alignment: " << packer.GetPaddingBytes() << " bytes\n";
+            }
+            return exitCode;
+        }
+
         try {
-            std::ifstream in(outputFile, std::ios::binary);
-            if (in) {
-                ArchHeader header;
-                if (in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
-                    if (header.magic == ArchConstants::MAGIC) {
-                        std::cout << "\nArchive berhasil dibuat!\n";
-                        std::cout << "Waktu proses: " << duration.count() << " ms\n";
-                        std::cout << "Detail Archive:\n";
-                        std::cout << "  Jumlah file: " << header.fileCount << "\n";
-                        std::cout << "  Ukuran file: " << fs::file_size(outputFile) << " bytes\n";
-                        return 0;
-                    }
+            ArchReader reader;
+            if (reader.Open(outputFile, options.volumeDirs)) {
+                std::cout << "\nArchive berhasil dibuat!\n";
+                std::cout << "Waktu proses: " << duration.count() << " ms\n";
+                std::cout << "Detail Archive:\n";
+                std::cout << "  Jumlah file: " << reader.GetEntryCount() << "\n";
+                // Volume 0 adalah file output itu sendiri; volume lain ikut dihitung
+                uint64_t archiveSize = 0;
+                for (uint32_t volume = 0; volume < reader.GetVolumeCount(); ++volume) {
+                    archiveSize += fs::file_size(reader.GetVolumePath(volume));
+                }
+                std::cout << "  Ukuran file: " << archiveSize << " bytes";
+                if (reader.GetVolumeCount() > 1) {
+                    std::cout << " dalam " << reader.GetVolumeCount() << " volume";
+                }
+                std::cout << "\n";
+                if (packer.GetPaddingBytes() > 0) {
+                    std::cout << "  Padding alignment: " << packer.GetPaddingBytes() << " bytes ("
+                        << std::fixed << std::setprecision(2)
+                        << (100.0 * packer.GetPaddingBytes() / archiveSize) << "%)\n";
                 }
+                if (!failures.empty()) {
+                    std::cout << "  PERINGATAN: " << failures.size() << " file gagal dikemas dan tidak ada di archive\n";
+                }
+                return exitCode;
             }
             std::cerr << "Warning: Gagal membaca info archive setelah pembuatan\n";
-            return 0;
+            return exitCode;
         }
         catch (const std::exception& e) {
             std::cerr << "Warning: Error verifikasi archive - " << e.what() << "\n";
-            return 0;
+            return exitCode;
         }
     }
     catch (const std::exception& e) {
@@ -16,6 +16,7 @@
 #include <string>
 #include <algorithm>
 #include <memory>
+#include <functional>
 #include "arch_crypto.h"
 
 // Third Party
@@ -24,7 +25,19 @@
 
 namespace ArchConstants {
     const uint32_t MAGIC = 0x48435241; // 'ARCH' in little-endian
-    const uint32_t VERSION = 1;
+    const uint32_t FOOTER_MAGIC = 0x46435241; // 'ARCF' in little-endian
+    const uint32_t LOCAL_MAGIC = 0x4C435241; // 'ARCL' in little-endian
+    const uint32_t LOCAL_END_MAGIC = 0x45435241; // 'ARCE' in little-endian
+    const uint32_t DELTA_MAGIC = 0x44435241; // 'ARCD' in little-endian
+    const uint32_t VOLUME_MAGIC = 0x56435241; // 'ARCV' in little-endian
+    const uint32_t CHUNK_MAGIC = 0x5A435241; // 'ARCZ' in little-endian
+    // Versi 2: kompresi chunked (compressionType 2), checksum header/blok dan
+    // multi-volume. Archive dengan versi lebih baru dari ini ditolak
+    const uint32_t VERSION = 2;
     const size_t MAX_FILENAME_LENGTH = 260; 
     const size_t HEADER_SIZE = 64; 
+    const uint32_t CHECK_BLOCK_SIZE = 65536; // granularitas checksum blok
+    const uint32_t COMPRESS_CHUNK_SIZE = 2 * 1024 * 1024; // potongan kompresi paralel
+    const uint32_t TASK_BATCH_BYTES = 1024 * 1024; // file kecil per tugas scheduler
+    const uint32_t TASK_BATCH_FILES = 64;
 }
\ No newline at end of file